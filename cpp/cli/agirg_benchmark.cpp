@@ -0,0 +1,82 @@
+#include <omp.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "CLI11.hpp"
+#include "app.hpp"
+#include "csv_writer.hpp"
+#include "girg.hpp"
+#include "random.hpp"
+#include "timer.hpp"
+#include "types.hpp"
+
+int main(int argc, char** argv) {
+  App app{
+      "Compare the running times of the two AGIRG generators: filtering a "
+      "GIRG supergraph (agirg) and sampling the edges directly (native).  "
+      "For each value of sigma, both generators use the same weights and "
+      "positions.  Prints one csv line per generator and sigma."};
+
+  unsigned n = 100000;
+  app.arg(n, "--nr_nodes,-n",
+          "Number of nodes of the generated graphs (default: 100000).");
+
+  double deg = 15;
+  app.arg(deg, "--deg", "Expected average degree (default: 15).");
+
+  unsigned dim = 1;
+  app.arg(dim, "--dim", "The Dimension of the ground space (default: 1).",
+          CLI::PositiveNumber);
+
+  double ple = 2.5;
+  app.arg(ple, "--ple", "The power-law exponent (default: 2.5).",
+          CLI::PositiveNumber & !CLI::Range(0.0, 2.0));
+
+  double T = 0;
+  app.arg(T, "--temperature,-T", "The temperature (default: 0).",
+          CLI::Range(0.0, 1.0));
+
+  std::vector<double> sigmas = {0.2, 0.4, 0.6, 0.8, 1.0, 1.2, 1.4, 1.6, 1.8};
+  app.arg_list(sigmas, "--sigmas",
+               "Comma separated list of values for sigma (default: 0.2, 0.4, "
+               "..., 1.8).",
+               CLI::Range(0.0, 2.0));
+
+  unsigned nr_threads = omp_get_max_threads();
+  app.arg(nr_threads, "--threads",
+          "Number of threads (default: number of cores).");
+
+  app.arg_header("n,deg,dim,ple,T,sigma,seed,generator,nr_edges,time");
+
+  app.arg_seed();
+
+  app.parse(argc, argv);
+
+  omp_set_num_threads(nr_threads);
+  unsigned seed = Random::get_seed();
+
+  for (double sigma : sigmas) {
+    double correction_factor =
+        sigma == 1.0 ? 1.0
+                     : agirg_correction_factor(n, ple, deg, dim, T, sigma);
+
+    for (std::string generator : {"agirg", "native"}) {
+      std::string timer = generator + std::to_string(sigma);
+      Timer::create_timer(timer);
+      Random::set_seed(seed);
+      Timer::start_timer(timer);
+      auto edges = generator == "agirg"
+                       ? agirg(n, ple, deg, dim, T, sigma, correction_factor)
+                       : agirg_native(n, ple, deg, dim, T, sigma,
+                                      correction_factor);
+      Timer::stop_timer(timer);
+      CsvWriter csv(std::cout);
+      print_csv_line(csv, n, deg, dim, ple, T, sigma, seed, generator,
+                     edges.size(), Timer::time(timer).count());
+    }
+  }
+
+  return 0;
+}
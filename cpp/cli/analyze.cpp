@@ -0,0 +1,117 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "CLI11.hpp"
+#include "analysis.hpp"
+#include "app.hpp"
+#include "edge_list.hpp"
+#include "types.hpp"
+
+int main(int argc, char** argv) {
+  App app{
+      "Evaluate a graph in several ways, parsing it only once.  Each "
+      "evaluation is written to the specified file, in the same format as "
+      "the respective tool (`stats`, `degree_distribution`, "
+      "`joint_histogram`, `joint_degree_distr`, and `edge_degrees`), "
+      "including the header.  The files are written in this order."};
+
+  std::filesystem::path input_file;
+  app.arg(input_file, "input_file", "Name of the file containing the graph.");
+
+  std::string stats_file = "";
+  app.arg(stats_file, "--stats", "Write the output of `stats` to this file.");
+
+  std::string degree_distr_file = "";
+  app.arg(degree_distr_file, "--degree_distr",
+          "Write the degree distributions to this file: the plain degree "
+          "distribution, the edge endpoint variant, and the edge endpoint "
+          "variant restricted to each of the selected buckets.");
+
+  std::string joint_degree_distr_file = "";
+  app.arg(joint_degree_distr_file, "--joint_degree_distr",
+          "Write the output of `joint_degree_distr` to this file.");
+
+  std::string edge_degrees_file = "";
+  app.arg(edge_degrees_file, "--edge_degrees",
+          "Write the output of `edge_degrees` to this file (not for "
+          "bipartite graphs, which are rejected with an error).");
+
+  std::string joint_histogram_file = "";
+  app.arg(joint_histogram_file, "--joint_histogram",
+          "Write the output of `joint_histogram` to this file.");
+
+  std::string format = "csv";
+  app.arg(format, "--format",
+          "Format of the joint degree distribution and the edge degrees: "
+          "csv, or the columnar binary format, either plain (binary) or "
+          "delta encoded (compressed) (default: csv).",
+          table_format_names);
+
+  unsigned nr_buckets = 21;
+  app.arg(nr_buckets, "--nr_buckets",
+          "The number of buckets for the joint histogram and the restricted "
+          "edge endpoint degree distributions (default: 21).");
+
+  std::vector<unsigned> buckets = {0, 5, 10, 15, 20};
+  app.arg_list(buckets, "--buckets",
+               "The buckets for the restricted edge endpoint degree "
+               "distributions (default: 0,5,10,15,20).");
+
+  app.parse(argc, argv);
+
+  if (!valid_buckets(buckets, nr_buckets)) return 1;
+
+  std::ifstream f(input_file);
+  EdgeList EL(f, false);
+  if (edge_degrees_file != "" && EL.type() == BIPARTITE) {
+    std::cerr << "ERROR: --edge_degrees is not supported for bipartite "
+                 "graphs (the edge degrees use the sum of in- and "
+                 "out-degree)."
+              << std::endl;
+    return 1;
+  }
+
+  if (stats_file != "") {
+    std::ofstream out{stats_file};
+    out << stats_header << "\n";
+    print_stats(EL, out);
+  }
+
+  if (degree_distr_file != "") {
+    std::ofstream out{degree_distr_file};
+    out << degree_distribution_header << "\n";
+    print_degree_distributions(EL, out, nr_buckets, buckets);
+  }
+
+  // the joint degree points are shared by the remaining evaluations
+  // (for the edge degrees, they coincide unless the graph is
+  // bipartite)
+  std::vector<Point> points;
+  if (joint_degree_distr_file != "" || edge_degrees_file != "" ||
+      joint_histogram_file != "") {
+    points = joint_degree_points(EL);
+  }
+
+  if (joint_degree_distr_file != "") {
+    std::ofstream out{joint_degree_distr_file, std::ios::binary};
+    if (format == "csv") out << joint_degree_distr_header << "\n";
+    print_joint_degree_distr(points, out, table_format(format));
+  }
+
+  if (edge_degrees_file != "") {
+    std::ofstream out{edge_degrees_file, std::ios::binary};
+    if (format == "csv") out << edge_degrees_header << "\n";
+    print_edge_degrees(points, out, table_format(format));
+  }
+
+  if (joint_histogram_file != "") {
+    std::ofstream out{joint_histogram_file};
+    out << joint_histogram_header << "\n";
+    print_joint_histogram(points, out, nr_buckets);
+  }
+
+  return 0;
+}
@@ -1,6 +1,10 @@
 #include <fstream>
+#include <string>
+#include <vector>
 
 #include "app.hpp"
+#include "binary_edges.hpp"
+#include "csv_writer.hpp"
 #include "edge_list.hpp"
 #include "random_graph.hpp"
 
@@ -8,7 +12,9 @@ int main(int argc, char** argv) {
   App app{"Generating Chung-Lu random graphs with power-law distribution."};
 
   std::string output_file = "output_graph";
-  app.arg(output_file, "output_file", "Name of the resulting graph file.");
+  app.arg(output_file, "output_file",
+          "Name of the resulting graph file.  With --seeds, the name has to "
+          "contain the placeholder {seed}.");
 
   unsigned n = 100;
   app.arg(n, "--nr_nodes,-n", "Number of nodes of the generated graph.");
@@ -24,18 +30,70 @@ int main(int argc, char** argv) {
   app.arg(sigma, "--sigma",
           "The exponent controlling the assortativity (default: 1).");
 
+  double tolerance = 1e-6;
+  app.arg(tolerance, "--tolerance",
+          "Relative error allowed for the expected average degree "
+          "(default: 1e-6).  Smaller values make the calibration use finer "
+          "weight classes and thus take longer.",
+          CLI::PositiveNumber);
+
+  std::vector<unsigned> seeds;
+  app.arg_list(seeds, "--seeds",
+               "Comma separated list of seeds.  One graph is generated for "
+               "each seed (in parallel, computing the weights only once).  "
+               "Each graph is written to output_file with {seed} replaced by "
+               "the respective seed.  Overrides --seed.");
+
+  bool out_of_core = false;
+  app.arg(out_of_core, "--out_of_core",
+          "Generate the graph in bounded memory (for huge graphs), streaming "
+          "the edges to output_file in a compact binary format, which can be "
+          "read by all tools.  The graphs differ from those generated "
+          "without this option.");
+
   app.arg_header("n,deg,ple,sigma,seed");
 
   app.arg_seed();
   app.parse(argc, argv);
 
-  auto edges = chung_lu(n, ple, deg, sigma);
+  if (!seeds.empty() && output_file.find("{seed}") == std::string::npos) {
+    std::cerr << "ERROR: the output file needs the placeholder {seed} when "
+                 "using --seeds."
+              << std::endl;
+    return 1;
+  }
+  if (seeds.empty()) seeds.push_back(Random::get_seed());
+
+  if (out_of_core) {
+    // one graph after the other, each using all threads
+    ChungLuOutOfCore params(n, ple, deg, sigma, tolerance);
+    for (unsigned seed : seeds) {
+      Random::set_seed(seed);
+      std::ofstream out(
+          fill_placeholder(output_file, "{seed}", std::to_string(seed)),
+          std::ios::binary);
+      BinaryEdgeWriter writer(out, UNDIRECTED, n);
+      chung_lu(params, [&](const std::vector<Edge>& edges) {
+        writer.write(edges);
+      });
+      CsvWriter csv(std::cout);
+      print_csv_line(csv, n, deg, ple, sigma, seed);
+    }
+    return 0;
+  }
 
-  std::ofstream out(output_file);
-  print_edges(edges, out);
+  ChungLuWeights weights(n, ple, deg, sigma, tolerance);
+  for_each_seed(seeds, [&](std::size_t i) {
+    auto edges = chung_lu(weights);
+    std::ofstream out(
+        fill_placeholder(output_file, "{seed}", std::to_string(seeds[i])));
+    print_edges(edges, out);
+  });
 
-  std::cout << n << "," << deg << "," << ple << "," << sigma << ","
-            << Random::get_seed() << std::endl;
+  CsvWriter csv(std::cout);
+  for (unsigned seed : seeds) {
+    print_csv_line(csv, n, deg, ple, sigma, seed);
+  }
 
   return 0;
 }
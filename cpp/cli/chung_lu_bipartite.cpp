@@ -0,0 +1,54 @@
+#include <fstream>
+
+#include "app.hpp"
+#include "csv_writer.hpp"
+#include "random_graph.hpp"
+
+int main(int argc, char** argv) {
+  App app{
+      "Generating bipartite Chung-Lu random graphs with power-law degree "
+      "distributions in both partitions.  The graph is written in the KONECT "
+      "format (with the `% bip` header)."};
+
+  std::string output_file = "output_graph";
+  app.arg(output_file, "output_file", "Name of the resulting graph file.");
+
+  unsigned n1 = 100;
+  app.arg(n1, "--n1", "Number of nodes in the first partition.");
+
+  unsigned n2 = 100;
+  app.arg(n2, "--n2", "Number of nodes in the second partition.");
+
+  double deg = 15;
+  app.arg(deg, "--deg",
+          "Expected average degree over all nodes (default: 15).");
+
+  double ple1 = 2.5;
+  app.arg(ple1, "--ple1",
+          "The power-law exponent of the first partition (default: 2.5).",
+          CLI::PositiveNumber & !CLI::Range(0.0, 2.0));
+
+  double ple2 = 2.5;
+  app.arg(ple2, "--ple2",
+          "The power-law exponent of the second partition (default: 2.5).",
+          CLI::PositiveNumber & !CLI::Range(0.0, 2.0));
+
+  double sigma = 1.0;
+  app.arg(sigma, "--sigma",
+          "The exponent controlling the assortativity (default: 1).");
+
+  app.arg_header("n1,n2,deg,ple1,ple2,sigma,seed");
+
+  app.arg_seed();
+  app.parse(argc, argv);
+
+  auto edges = chung_lu_bipartite(n1, n2, ple1, ple2, deg, sigma);
+
+  std::ofstream out(output_file);
+  print_edges_konect(edges, BIPARTITE, out);
+
+  CsvWriter csv(std::cout);
+  print_csv_line(csv, n1, n2, deg, ple1, ple2, sigma, Random::get_seed());
+
+  return 0;
+}
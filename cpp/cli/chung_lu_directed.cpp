@@ -0,0 +1,59 @@
+#include <fstream>
+
+#include "app.hpp"
+#include "csv_writer.hpp"
+#include "random_graph.hpp"
+
+int main(int argc, char** argv) {
+  App app{
+      "Generating directed Chung-Lu random graphs with power-law in- and "
+      "out-degree distributions.  The graph is written in the KONECT format "
+      "(with the `% asym` header)."};
+
+  std::string output_file = "output_graph";
+  app.arg(output_file, "output_file", "Name of the resulting graph file.");
+
+  unsigned n = 100;
+  app.arg(n, "--nr_nodes,-n", "Number of nodes of the generated graph.");
+
+  double deg = 15;
+  app.arg(deg, "--deg",
+          "Expected average degree, counting in- and out-edges (default: 15).");
+
+  double ple_out = 2.5;
+  app.arg(ple_out, "--ple_out",
+          "The power-law exponent of the out-degrees (default: 2.5).",
+          CLI::PositiveNumber & !CLI::Range(0.0, 2.0));
+
+  double ple_in = 2.5;
+  app.arg(ple_in, "--ple_in",
+          "The power-law exponent of the in-degrees (default: 2.5).",
+          CLI::PositiveNumber & !CLI::Range(0.0, 2.0));
+
+  double correlation = 1.0;
+  app.arg(correlation, "--correlation",
+          "Correlation between in- and out-weights: 1 gives every vertex the "
+          "same in- and out-weight rank, 0 assigns them independently "
+          "(default: 1).",
+          CLI::Range(0.0, 1.0));
+
+  double sigma = 1.0;
+  app.arg(sigma, "--sigma",
+          "The exponent controlling the assortativity (default: 1).");
+
+  app.arg_header("n,deg,ple_out,ple_in,correlation,sigma,seed");
+
+  app.arg_seed();
+  app.parse(argc, argv);
+
+  auto edges = chung_lu_directed(n, ple_out, ple_in, deg, correlation, sigma);
+
+  std::ofstream out(output_file);
+  print_edges_konect(edges, DIRECTED, out);
+
+  CsvWriter csv(std::cout);
+  print_csv_line(csv, n, deg, ple_out, ple_in, correlation, sigma,
+                 Random::get_seed());
+
+  return 0;
+}
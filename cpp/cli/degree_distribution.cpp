@@ -1,16 +1,12 @@
-#include <algorithm>
-#include <cmath>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
-#include <numeric>
-#include <utility>
+#include <vector>
 
 #include "CLI11.hpp"
+#include "analysis.hpp"
 #include "app.hpp"
 #include "edge_list.hpp"
-#include "histogram.hpp"
-#include "types.hpp"
 
 int main(int argc, char** argv) {
   App app{
@@ -39,57 +35,31 @@ int main(int argc, char** argv) {
   unsigned bucket = 0;
   app.arg(bucket, "--bucket", "The selected bucket.");
 
-  app.arg_header(
-      "degree,frequency,edge_endpoints,nr_buckets,bucket,neighbor_deg_lb,"
-      "neighbor_deg_ub");
+  std::vector<unsigned> buckets;
+  app.arg_list(buckets, "--buckets",
+               "Comma separated list of selected buckets.  The distributions "
+               "for all of them are computed in a single pass over the edges "
+               "(one after the other in the output).  Overrides --bucket.");
 
-  app.parse(argc, argv);
+  app.arg_header(degree_distribution_header);
 
-  double ndeg_lb = 0, ndeg_ub = 0;
+  app.parse(argc, argv);
 
-  auto write_histogram = [&](const Histogram& H) {
-    for (unsigned deg = 0; deg <= H.maximum(); ++deg) {
-      if (H.frequency(deg) > 0) {
-        print_csv_line(std::cout, deg, H.frequency(deg), edge_endpoints,
-                       nr_buckets, bucket, ndeg_lb, ndeg_ub);
-      }
-    }
-  };
+  if (edge_endpoints &&
+      !valid_buckets(buckets.empty() ? std::vector{bucket} : buckets,
+                     nr_buckets)) {
+    return 1;
+  }
 
   std::ifstream f(input_file);
-  EdgeList EL(f);
+  EdgeList EL(f, false);
 
-  // degree distribution (random vertex)
-  Histogram H_deg;
-  if (EL.type() == BIPARTITE) {
-    for (Node v = 0; v < EL.n1(); ++v) H_deg.add(EL.deg(OUT, v));
-    for (Node v = 0; v < EL.n2(); ++v) H_deg.add(EL.deg(IN, v));
+  if (edge_endpoints && !buckets.empty()) {
+    print_bucketed_degree_distributions(EL, std::cout, nr_buckets, buckets);
   } else {
-    for (Node v = 0; v < EL.n(); ++v) H_deg.add(EL.deg(SUM, v));
-  }
-
-  if (!edge_endpoints) {
-    write_histogram(H_deg);
-    return 0;
-  }
-
-  // edge endpoints
-  Histogram H;
-  
-  // logarithmic breaks -> upper and lower bounds for neighbor degree
-  auto breaks = log_breaks(1, H_deg.maximum() + 1, nr_buckets);
-  ndeg_lb = breaks[bucket];
-  ndeg_ub = breaks[bucket + 1];
-
-  for (auto& e : EL.edges()) {
-    unsigned deg_s =
-        EL.type() != BIPARTITE ? EL.deg(SUM, e.s) : EL.deg(OUT, e.s);
-    unsigned deg_t =
-        EL.type() != BIPARTITE ? EL.deg(SUM, e.t) : EL.deg(IN, e.t);
-    if (ndeg_lb <= deg_s && deg_s <= ndeg_ub) H.add(deg_t);
-    if (ndeg_lb <= deg_t && deg_t <= ndeg_ub) H.add(deg_s);
+    print_degree_distribution(EL, std::cout, edge_endpoints, nr_buckets,
+                              bucket);
   }
-  write_histogram(H);
 
   return 0;
 }
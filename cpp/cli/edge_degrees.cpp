@@ -1,7 +1,9 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <string>
 
+#include "analysis.hpp"
 #include "app.hpp"
 #include "types.hpp"
 #include "edge_list.hpp"
@@ -12,16 +14,29 @@ int main(int argc, char** argv) {
   std::filesystem::path input_file;
   app.arg(input_file, "input_file", "Name of the file containing the graph.");
 
-  app.arg_header("source,target");
+  std::string format = "csv";
+  app.arg(format, "--format",
+          "Output format: csv, or the columnar binary format, either plain "
+          "(binary) or delta encoded (compressed).  The binary formats "
+          "contain the column names instead of the csv-header (default: "
+          "csv).",
+          table_format_names);
+
+  app.arg_header(edge_degrees_header);
+  app.skip_header_if([&] { return format != "csv"; });
 
   app.parse(argc, argv);
 
   std::ifstream f(input_file);
-  EdgeList EL(f);
-  auto points = EL.degree_points(SUM, SUM);
-  for (auto& p : points) {
-    std::cout << p.x << "," << p.y << "\n";
+  EdgeList EL(f, false);
+  if (EL.type() == BIPARTITE) {
+    std::cerr << "ERROR: the edge degrees (sum of in- and out-degree) are "
+                 "not defined for bipartite graphs."
+              << std::endl;
+    return 1;
   }
+  print_edge_degrees(EL.degree_points(SUM, SUM), std::cout,
+                     table_format(format));
 
   return 0;
 }
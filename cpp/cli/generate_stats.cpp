@@ -0,0 +1,111 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CLI11.hpp"
+#include "analysis.hpp"
+#include "app.hpp"
+#include "edge_list.hpp"
+#include "generate.hpp"
+#include "random.hpp"
+#include "types.hpp"
+
+int main(int argc, char** argv) {
+  App app{
+      "Generate a GIRG or Chung-Lu graph and directly evaluate it, without "
+      "writing the graph to disk and parsing it again.  The generator "
+      "attributes are printed (as by `girg` and `chung_lu`); the evaluations "
+      "are written to the specified files (as by `stats`, "
+      "`degree_distribution` and `joint_histogram`, including the header)."};
+
+  GeneratorParams p;
+  app.arg(p.model, "--model", "The random graph model (default: girg).",
+          {"girg", "cl"});
+
+  app.arg(p.n, "--nr_nodes,-n",
+          "Number of nodes of the generated graph (default: 100).");
+
+  app.arg(p.deg, "--deg", "Expected average degree (default: 15).");
+
+  app.arg(p.dim, "--dim",
+          "The Dimension of the ground space; only for GIRGs (default: 1).",
+          CLI::PositiveNumber);
+
+  app.arg(p.ple, "--ple", "The power-law exponent (default: 2.5).",
+          CLI::PositiveNumber & !CLI::Range(0.0, 2.0));
+
+  app.arg(p.T, "--temperature,-T",
+          "The temperature; only for GIRGs (default: 0).",
+          CLI::Range(0.0, 1.0));
+
+  app.arg(p.sigma, "--sigma",
+          "The exponent controlling the assortativity (default: 1).",
+          CLI::Range(0.0, 2.0));
+
+  std::string graph_file = "";
+  app.arg(graph_file, "--graph",
+          "Additionally write the generated graph to this file.");
+
+  std::string stats_file = "";
+  app.arg(stats_file, "--stats", "Write the output of `stats` to this file.");
+
+  std::string degree_distr_file = "";
+  app.arg(degree_distr_file, "--degree_distr",
+          "Write the degree distributions to this file: the plain degree "
+          "distribution, the edge endpoint variant, and the edge endpoint "
+          "variant restricted to each of the selected buckets.");
+
+  std::string joint_histogram_file = "";
+  app.arg(joint_histogram_file, "--joint_histogram",
+          "Write the output of `joint_histogram` to this file.");
+
+  unsigned nr_buckets = 21;
+  app.arg(nr_buckets, "--nr_buckets",
+          "The number of buckets for the joint histogram and the restricted "
+          "edge endpoint degree distributions (default: 21).");
+
+  std::vector<unsigned> buckets = {0, 5, 10, 15, 20};
+  app.arg_list(buckets, "--buckets",
+               "The buckets for the restricted edge endpoint degree "
+               "distributions (default: 0,5,10,15,20).");
+
+  app.arg_seed();
+
+  app.parse(argc, argv);
+
+  p.seed = Random::get_seed();
+
+  auto edges = generate(p);
+
+  if (graph_file != "") {
+    std::ofstream out{graph_file};
+    print_edges(edges, out);
+  }
+
+  EdgeList EL(std::move(edges), UNDIRECTED, false);
+
+  if (stats_file != "") {
+    std::ofstream out{stats_file};
+    out << stats_header << "\n";
+    print_stats(EL, out);
+  }
+
+  if (degree_distr_file != "") {
+    std::ofstream out{degree_distr_file};
+    out << degree_distribution_header << "\n";
+    print_degree_distributions(EL, out, nr_buckets, buckets);
+  }
+
+  if (joint_histogram_file != "") {
+    std::ofstream out{joint_histogram_file};
+    out << joint_histogram_header << "\n";
+    print_joint_histogram(EL, out, nr_buckets);
+  }
+
+  std::cout << attribute_header(p.model) << "\n";
+  print_attributes(p, std::cout);
+
+  return 0;
+}
@@ -5,10 +5,12 @@
 #include <cassert>
 #include <cmath>
 #include <limits>
+#include <string>
 #include <vector>
 
 #include "CLI11.hpp"
 #include "app.hpp"
+#include "csv_writer.hpp"
 #include "random.hpp"
 #include "types.hpp"
 
@@ -16,7 +18,9 @@ int main(int argc, char** argv) {
   App app{"Generating geometric inhomogeneous random graphs."};
 
   std::string output_file = "output_graph";
-  app.arg(output_file, "output_file", "Name of the resulting graph file.");
+  app.arg(output_file, "output_file",
+          "Name of the resulting graph file.  With --sigmas (--seeds), the "
+          "name has to contain the placeholder {sigma} ({seed}).");
 
   unsigned n = 100;
   app.arg(n, "--nr_nodes,-n",
@@ -42,59 +46,93 @@ int main(int argc, char** argv) {
           "The exponent controlling the assortativity (default: 1).",
           CLI::Range(0.0, 2.0));
 
+  std::vector<std::string> sigmas;
+  app.arg_list(sigmas, "--sigmas",
+               "Comma separated list of values for sigma.  The graphs for all "
+               "values are generated from the same GIRG supergraph (coupled "
+               "graphs), which is faster than generating them one by one.  "
+               "Each graph is written to output_file with {sigma} replaced by "
+               "the respective value.  Overrides --sigma.",
+               CLI::Range(0.0, 2.0));
+
+  std::vector<unsigned> seeds;
+  app.arg_list(seeds, "--seeds",
+               "Comma separated list of seeds.  The graphs for all seeds are "
+               "generated in parallel, computing the (calibrated) weights "
+               "only once.  Each graph is written to output_file with {seed} "
+               "replaced by the respective seed.  Overrides --seed.");
+
   bool print_ipe = false;
   app.arg(print_ipe, "--ipe", "Set to print the coordinates.");  
 
+  unsigned nr_threads = omp_get_max_threads();
+  app.arg(nr_threads, "--threads",
+          "Number of threads (default: number of cores).  The generated graph "
+          "does not depend on the number of threads.");
+
   app.arg_header("n,deg,dim,ple,T,alpha,sigma,seed");
 
   app.arg_seed();
 
   app.parse(argc, argv);
 
-  omp_set_num_threads(1);
-
-  double correction_factor = 1.0;
-  std::string ipe_output = print_ipe && sigma == 1.0 ? output_file + ".ipe" : "";
-  auto edges = agirg(n, ple, deg, dim, T, sigma, 1.0// , ipe_output
-                     );
-
-  // if sigma != 1, the average degree is probably off quite a bit ->
-  // correct it by running it again with a correction factor
-  if (sigma != 1.0 || ipe_output != "") {
-    // adjusting the average degree by a factor either under- or
-    // overshoots the desired amount of change (depending on σ) -> fix
-    // this by dampen (or amplify) the amount of change depending on σ
-    auto dampen = [&sigma](double factor) {
-      return std::pow(factor, 1.2 / sigma);
-    };
-    
-    auto log = [&]() {
-      // std::cout << "correction: " << correction_factor << std::endl;
-      // std::cout << "avg deg: " << edges.size() * 2.0 / n << std::endl;
-    };
-
-    // adjusting the average degree three times yields graphs with
-    // roughly the right degree in most cases
-    for (int i = 0; i < 3; ++i) {
-      if (i == 0) log();
-      correction_factor *= dampen(0.5 * n * deg / edges.size());
-      ipe_output = print_ipe && i == 2 ? output_file + ".ipe" : "";
-      edges = agirg(n, ple, deg, dim, T, sigma, correction_factor, ipe_output);
-      log();
-    }
+  omp_set_num_threads(nr_threads);
+
+  auto missing = [](const std::string& placeholder,
+                    const std::string& option) {
+    std::cerr << "ERROR: the output file needs the placeholder " << placeholder
+              << " when using " << option << "." << std::endl;
+    return 1;
+  };
+  if (!sigmas.empty() && output_file.find("{sigma}") == std::string::npos) {
+    return missing("{sigma}", "--sigmas");
+  }
+  if (!seeds.empty() && output_file.find("{seed}") == std::string::npos) {
+    return missing("{seed}", "--seeds");
   }
 
-  // subsample and write edges
-  std::ofstream out{output_file};
-  for (auto& e : edges) {
-    auto [u, v] = e;
-    out << u << ' ' << v << '\n';
+  // one output file per value of sigma (and seed)
+  std::vector<double> sigma_values;
+  if (sigmas.empty()) {
+    sigma_values.push_back(sigma);
+    sigmas.push_back("");
+  } else {
+    for (const std::string& s : sigmas) sigma_values.push_back(std::stod(s));
   }
+  if (seeds.empty()) seeds.push_back(Random::get_seed());
+
+  // the weights only depend on sigma, the positions and edges also on
+  // the seed
+  auto weights = agirg_calibrated_weights(n, ple, deg, dim, T, sigma_values);
+  for_each_seed(seeds, [&](std::size_t i) {
+    std::vector<std::string> output_files, ipe_outputs;
+    for (const std::string& s : sigmas) {
+      output_files.push_back(fill_placeholder(
+          fill_placeholder(output_file, "{sigma}", s), "{seed}",
+          std::to_string(seeds[i])));
+      ipe_outputs.push_back(print_ipe ? output_files.back() + ".ipe" : "");
+    }
+    auto graphs = agirg_coupled(weights, ipe_outputs);
+
+    // write edges
+    for (unsigned j = 0; j < graphs.size(); ++j) {
+      std::ofstream out{output_files[j]};
+      CsvWriter csv(out, ' ');
+      for (auto& e : graphs[j]) {
+        auto [u, v] = e;
+        csv.line(u, v);
+      }
+    }
+  });
 
   // output parameters
   double alpha = T > 0 ? 1 / T : std::numeric_limits<double>::infinity();
-  std::cout << n << "," << deg << "," << dim << "," << ple << "," << T << ","
-            << alpha << "," << sigma << "," << Random::get_seed() << std::endl;
+  CsvWriter csv(std::cout);
+  for (unsigned seed : seeds) {
+    for (double s : sigma_values) {
+      print_csv_line(csv, n, deg, dim, ple, T, alpha, s, seed);
+    }
+  }
 
   return 0;
 }
@@ -0,0 +1,64 @@
+#include "hrg.hpp"
+
+#include <omp.h>
+
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "CLI11.hpp"
+#include "app.hpp"
+#include "csv_writer.hpp"
+#include "random.hpp"
+#include "types.hpp"
+
+int main(int argc, char** argv) {
+  App app{
+      "Generating hyperbolic random graphs (threshold or with temperature) "
+      "in expected time O(n log n + m)."};
+
+  std::string output_file = "output_graph";
+  app.arg(output_file, "output_file", "Name of the resulting graph file.");
+
+  unsigned n = 100;
+  app.arg(n, "--nr_nodes,-n",
+          "Number of nodes of the generated graph (default: 100).");
+
+  double deg = 15;
+  app.arg(deg, "--deg", "Expected average degree (default: 15).");
+
+  double ple = 2.5;
+  app.arg(ple, "--ple", "The power-law exponent (default: 2.5).",
+          CLI::PositiveNumber & !CLI::Range(0.0, 2.0));
+
+  double T = 0;
+  app.arg(T, "--temperature,-T", "The temperature (default: 0).",
+          CLI::Range(0.0, 1.0));
+
+  unsigned nr_threads = omp_get_max_threads();
+  app.arg(nr_threads, "--threads",
+          "Number of threads (default: number of cores).  The generated graph "
+          "does not depend on the number of threads.");
+
+  app.arg_header("n,deg,ple,T,alpha,R,seed");
+
+  app.arg_seed();
+
+  app.parse(argc, argv);
+
+  omp_set_num_threads(nr_threads);
+
+  auto graph = hrg(n, deg, ple, T);
+
+  std::ofstream out(output_file);
+  print_edges(graph.edges, out);
+
+  // output parameters
+  double alpha = T > 0 ? 1 / T : std::numeric_limits<double>::infinity();
+  CsvWriter csv(std::cout);
+  print_csv_line(csv, n, deg, ple, T, alpha, graph.R, Random::get_seed());
+
+  return 0;
+}
@@ -1,15 +1,13 @@
-#include <algorithm>
-#include <cmath>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
-#include <numeric>
-#include <utility>
+#include <string>
+#include <vector>
 
 #include "CLI11.hpp"
+#include "analysis.hpp"
 #include "app.hpp"
 #include "edge_list.hpp"
-#include "histogram.hpp"
 #include "types.hpp"
 
 int main(int argc, char** argv) {
@@ -19,41 +17,64 @@ int main(int argc, char** argv) {
       "appears. For undirected graphs, each edge contributes two points (one "
       "for each possible direction). For directed and bipartite graphs, each "
       "edge contributes one point. For directed graphs, the degree of the "
-      "vertices is the sum of in and out degree."};
+      "vertices is the sum of in and out degree, unless specified otherwise "
+      "via --source_type and --target_type."};
 
   std::filesystem::path input_file;
   app.arg(input_file, "input_file", "Name of the file containing the graph.");
 
-  app.arg_header("degree_s,degree_t,frequency");
+  std::vector<std::string> deg_types = {"out", "in", "sum"};
+  std::string source_type = "";
+  app.arg(source_type, "--source_type",
+          "Degree type (out, in, or sum) of the source of each edge.  Only "
+          "applicable to directed graphs (default: sum).",
+          deg_types);
+
+  std::string target_type = "";
+  app.arg(target_type, "--target_type",
+          "Degree type (out, in, or sum) of the target of each edge.  Only "
+          "applicable to directed graphs (default: sum).",
+          deg_types);
+
+  std::string format = "csv";
+  app.arg(format, "--format",
+          "Output format: csv, or the columnar binary format, either plain "
+          "(binary) or delta encoded (compressed).  The binary formats "
+          "contain the column names instead of the csv-header (default: "
+          "csv).",
+          table_format_names);
+
+  app.arg_header(joint_degree_distr_header);
+  app.skip_header_if([&] { return format != "csv"; });
 
   app.parse(argc, argv);
 
   std::ifstream f(input_file);
-  EdgeList EL(f);
-
-  // create histogram
-  auto points = EL.type() != BIPARTITE ? EL.degree_points(SUM, SUM)
-                                       : EL.degree_points(OUT, IN);
-  std::sort(points.begin(), points.end(), [](Point p1, Point p2) {
-    if (p1.x == p2.x) return p1.y < p2.y;
-    return p1.x < p2.x;
-  });
-
-  // sentinel element at the end
-  points.push_back({0, 0});
-
-  Point prev_point = points[0];
-  unsigned count = 1;
-
-  for (unsigned i = 1; i < points.size(); ++i) {
-    if (points[i].x == prev_point.x && points[i].y == prev_point.y) {
-      count++;
-      continue;
-    }
-    std::cout << prev_point.x << "," << prev_point.y << "," << count << "\n";
-    prev_point = points[i];
-    count = 1;
+  EdgeList EL(f, false);
+
+  auto deg_type = [&](const std::string& type, DegType default_type) {
+    if (type == "") return default_type;
+    return type == "out" ? OUT : type == "in" ? IN : SUM;
+  };
+  DegType default_source = EL.type() != BIPARTITE ? SUM : OUT;
+  DegType default_target = EL.type() != BIPARTITE ? SUM : IN;
+  DegType source = deg_type(source_type, default_source);
+  DegType target = deg_type(target_type, default_target);
+
+  // only directed graphs have different degree types
+  if (EL.type() != DIRECTED &&
+      (source != default_source || target != default_target)) {
+    std::cerr << "ERROR: the degree types of " << name(EL.type())
+              << " graphs are fixed (source: " << name(default_source)
+              << ", target: " << name(default_target)
+              << "); --source_type and --target_type only apply to "
+                 "directed graphs."
+              << std::endl;
+    return 1;
   }
 
+  print_joint_degree_distr(EL.degree_points(source, target), std::cout,
+                           table_format(format));
+
   return 0;
 }
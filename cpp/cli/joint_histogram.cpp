@@ -1,16 +1,12 @@
-#include <algorithm>
-#include <cmath>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
-#include <numeric>
-#include <utility>
+#include <vector>
 
 #include "CLI11.hpp"
+#include "analysis.hpp"
 #include "app.hpp"
 #include "edge_list.hpp"
-#include "histogram.hpp"
-#include "types.hpp"
 
 int main(int argc, char** argv) {
   App app{"todo"};
@@ -18,8 +14,11 @@ int main(int argc, char** argv) {
   std::filesystem::path input_file;
   app.arg(input_file, "input_file", "Name of the file containing the graph.");
 
-  unsigned nr_buckets = 20;
-  app.arg(nr_buckets, "--nr_buckets", "The number of buckets.");
+  std::vector<unsigned> nr_buckets = {20};
+  app.arg_list(nr_buckets, "--nr_buckets",
+               "The number of buckets.  For a comma separated list, one "
+               "histogram is computed for each number of buckets (from a "
+               "single scan of the graph).");
 
   bool complementary_cumulative = false;
   app.arg(complementary_cumulative, "--complementary_cumulative",
@@ -27,28 +26,24 @@ int main(int argc, char** argv) {
           "contains the number of points with x-value and y-value at least x "
           "and y, respectively.");
 
-  app.arg_header(
-      "lb_x,ub_x,center_x,lb_y,ub_y,center_y,count,nr_buckets,compl_cumul");
+  bool both_variants = false;
+  app.arg(both_variants, "--both_variants",
+          "Output the plain and the complementary cumulative histograms.");
+
+  app.arg_header(joint_histogram_header);
 
   app.parse(argc, argv);
 
   std::ifstream f(input_file);
-  EdgeList EL(f);
-
-  // create histogram
-  auto points = EL.type() != BIPARTITE ? EL.degree_points(SUM, SUM)
-                                       : EL.degree_points(OUT, IN);
-
-  Histogram2D H{points, nr_buckets, complementary_cumulative};
-
-  for (unsigned x = 0; x < nr_buckets; ++x) {
-    for (unsigned y = 0; y < nr_buckets; ++y) {
-      print_csv_line(std::cout,                            //
-                     H.lb_x(x), H.ub_x(x), H.center_x(x),  //
-                     H.lb_y(y), H.ub_y(y), H.center_y(y),  //
-                     H.count(x, y),                        //
-                     nr_buckets, complementary_cumulative);
-    }
+  EdgeList EL(f, false);
+
+  if (nr_buckets.size() == 1 && !both_variants) {
+    print_joint_histogram(EL, std::cout, nr_buckets[0],
+                          complementary_cumulative);
+  } else {
+    std::vector<bool> variants = {complementary_cumulative};
+    if (both_variants) variants = {false, true};
+    print_joint_histograms(EL, std::cout, nr_buckets, variants);
   }
 
   return 0;
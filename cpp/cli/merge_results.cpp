@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "CLI11.hpp"
+#include "app.hpp"
+#include "csv_writer.hpp"
+
+// splits the content of a csv file into its header and the remaining
+// lines (the latter ending with a newline, if not empty)
+std::pair<std::string_view, std::string_view> split_header(
+    std::string_view content) {
+  auto end = content.find('\n');
+  if (end == std::string_view::npos) return {content, ""};
+  return {content.substr(0, end), content.substr(end + 1)};
+}
+
+int main(int argc, char** argv) {
+  App app{
+      "Merge the csv files in a directory (one per graph, e.g., "
+      "output_data/stats/) into a single csv file, prepending the column "
+      "graph with the file name (without .csv) to each line.  All files "
+      "need the same header.  The files are read in parallel."};
+
+  std::string input_dir;
+  app.arg(input_dir, "input_dir",
+          "Directory containing the csv files (one per graph).",
+          CLI::ExistingDirectory);
+
+  std::string output_file = "";
+  app.arg(output_file, "--output,-o",
+          "The merged csv file (default: input_dir with the extension .csv, "
+          "e.g., output_data/stats.csv).");
+
+  app.parse(argc, argv);
+
+  std::filesystem::path dir{input_dir};
+  if (!dir.has_filename()) dir = dir.parent_path();  // trailing slash
+  if (output_file == "") output_file = dir.string() + ".csv";
+
+  std::vector<std::filesystem::path> files;
+  for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".csv") {
+      files.push_back(entry.path());
+    }
+  }
+  std::sort(files.begin(), files.end());
+  if (files.empty()) {
+    std::cerr << "ERROR: no csv files in " << dir << "." << std::endl;
+    return 1;
+  }
+
+  std::vector<std::string> contents(files.size());
+#pragma omp parallel for schedule(dynamic, 16)
+  for (std::size_t i = 0; i < files.size(); ++i) {
+    std::ifstream in(files[i], std::ios::binary);
+    contents[i].assign(std::istreambuf_iterator<char>(in),
+                       std::istreambuf_iterator<char>());
+  }
+
+  std::string_view header = split_header(contents[0]).first;
+  for (std::size_t i = 0; i < files.size(); ++i) {
+    if (split_header(contents[i]).first != header) {
+      std::cerr << "ERROR: the header of " << files[i]
+                << " differs from the header of " << files[0] << "."
+                << std::endl;
+      return 2;
+    }
+  }
+
+  std::ofstream out(output_file, std::ios::binary);
+  CsvWriter csv(out);
+  print_csv_line(csv, "graph", header);
+  for (std::size_t i = 0; i < files.size(); ++i) {
+    std::string graph = files[i].stem().string();
+    std::string_view lines = split_header(contents[i]).second;
+    while (!lines.empty()) {
+      auto end = std::min(lines.find('\n'), lines.size());
+      print_csv_line(csv, graph, lines.substr(0, end));
+      lines.remove_prefix(std::min(end + 1, lines.size()));
+    }
+  }
+
+  return 0;
+}
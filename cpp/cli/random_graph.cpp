@@ -1,9 +1,11 @@
 #include "random_graph.hpp"
 
+#include <cstdint>
 #include <fstream>
 #include <vector>
 
 #include "app.hpp"
+#include "csv_writer.hpp"
 #include "edge_list.hpp"
 
 int main(int argc, char** argv) {
@@ -43,6 +45,12 @@ int main(int argc, char** argv) {
     return 2;
   }
 
+  if (m > std::uint64_t(n) * (n - 1) / 2) {
+    std::cout << "ERROR: a graph with " << n << " nodes has at most "
+              << std::uint64_t(n) * (n - 1) / 2 << " edges." << std::endl;
+    return 3;
+  }
+
   std::vector<Edge> edges;
   double deg;
 
@@ -57,7 +65,8 @@ int main(int argc, char** argv) {
   std::ofstream out(output_file);
   print_edges(edges, out);
 
-  std::cout << n << "," << deg << std::endl;
+  CsvWriter csv(std::cout);
+  print_csv_line(csv, n, deg);
   
   return 0;
 }
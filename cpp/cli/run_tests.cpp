@@ -1,8 +1,18 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
+#include "app.hpp"
 #include "edge_list.hpp"
 #include "kendall.hpp"
 #include "pearson.hpp"
 #include "spearman.hpp"
 #include "histogram.hpp"
 #include "girg.hpp"
+#include "calibration.hpp"
+#include "agirg_sampler.hpp"
+#include "random.hpp"
+#include "random_graph.hpp"
+#include "hrg.hpp"
+#include "weights.hpp"
+#include "binary_edges.hpp"
+#include "csv_writer.hpp"
+#include "binary_table.hpp"
@@ -0,0 +1,299 @@
+#include <omp.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "CLI11.hpp"
+#include "analysis.hpp"
+#include "app.hpp"
+#include "csv_writer.hpp"
+#include "edge_list.hpp"
+#include "generate.hpp"
+
+// A single point of the parameter grid.  Besides the parsed
+// parameters, it stores the parameter values as strings (as they
+// appear in the grid file) to get the same graph names as
+// experiments.py.
+struct Job {
+  GeneratorParams params;
+  std::map<std::string, std::string> values;
+
+  std::string name(bool with_sigma = true, bool with_seed = true) const {
+    std::string res = values.at("model");
+    for (std::string key : {"n", "deg", "dim", "ple", "T", "sigma", "seed"}) {
+      if (values.at("model") == "cl" && (key == "dim" || key == "T")) continue;
+      if (!with_sigma && key == "sigma") continue;
+      if (!with_seed && key == "seed") continue;
+      res += "_" + key + "=" + values.at(key);
+    }
+    return res;
+  }
+};
+
+// Reads the parameter grid.  Each line consists of a key followed by
+// a colon and a whitespace separated list of values; everything after
+// a # is a comment.  The resulting jobs are all combinations of
+// values, except that dim and T are not varied for Chung-Lu graphs
+// (which do not depend on them).
+std::vector<Job> read_grid(const std::filesystem::path& grid_file) {
+  std::map<std::string, std::vector<std::string>> grid = {
+      {"model", {"girg"}}, {"n", {"100"}},  {"deg", {"15"}},
+      {"dim", {"1"}},      {"ple", {"2.5"}}, {"T", {"0"}},
+      {"sigma", {"1"}},    {"seed", {"0"}}};
+
+  std::ifstream input(grid_file);
+  std::string line;
+  while (std::getline(input, line)) {
+    line = line.substr(0, line.find('#'));
+    auto colon = line.find(':');
+    if (colon == std::string::npos) continue;
+    std::istringstream key_ss(line.substr(0, colon));
+    std::istringstream values_ss(line.substr(colon + 1));
+    std::string key, value;
+    key_ss >> key;
+    if (!grid.contains(key)) {
+      std::cerr << "ERROR: unknown parameter '" << key << "' in the grid."
+                << std::endl;
+      exit(1);
+    }
+    grid[key].clear();
+    while (values_ss >> value) grid[key].push_back(value);
+  }
+
+  std::vector<Job> jobs(1);
+  for (auto& [key, values] : grid) {
+    std::vector<Job> combined;
+    for (const Job& job : jobs) {
+      for (const std::string& value : values) {
+        combined.push_back(job);
+        combined.back().values[key] = value;
+      }
+    }
+    jobs = combined;
+  }
+
+  for (Job& job : jobs) {
+    GeneratorParams& p = job.params;
+    p.model = job.values["model"];
+    p.n = std::stoul(job.values["n"]);
+    p.deg = std::stod(job.values["deg"]);
+    p.dim = std::stoul(job.values["dim"]);
+    p.ple = std::stod(job.values["ple"]);
+    p.T = std::stod(job.values["T"]);
+    p.sigma = std::stod(job.values["sigma"]);
+    p.seed = std::stoul(job.values["seed"]);
+    if (p.model != "girg" && p.model != "cl") {
+      std::cerr << "ERROR: unknown model '" << p.model << "'." << std::endl;
+      exit(1);
+    }
+  }
+
+  // Chung-Lu jobs only differing in dim or T have the same name
+  std::unordered_set<std::string> names;
+  std::erase_if(jobs, [&](const Job& job) {
+    return !names.insert(job.name()).second;
+  });
+  return jobs;
+}
+
+// The complete lines of a merged csv file (without the header), i.e.,
+// without an unfinished last line left by an interrupted sweep.
+std::vector<std::string> merged_rows(const std::filesystem::path& file) {
+  std::vector<std::string> rows;
+  std::ifstream input(file);
+  std::string line;
+  std::getline(input, line);  // header
+  while (std::getline(input, line) && !input.eof()) rows.push_back(line);
+  return rows;
+}
+
+// name of the graph of a row of a merged csv file
+std::string graph_of(const std::string& row) {
+  return row.substr(0, row.find(','));
+}
+
+// A merged csv file as produced by merge_results, i.e.,
+// each row starts with the name of the graph.  Rows are appended,
+// such that an interrupted sweep can be continued.
+class MergedCsv {
+ public:
+  // Keeps only the rows of the complete graphs, dropping the rows an
+  // interrupted sweep wrote for other graphs (which are generated
+  // again) and an unfinished last line.
+  MergedCsv(const std::filesystem::path& file, const std::string& header,
+            const std::unordered_set<std::string>& complete) {
+    if (std::filesystem::exists(file)) {
+      auto rows = merged_rows(file);
+      std::erase_if(rows, [&](const std::string& row) {
+        return !complete.contains(graph_of(row));
+      });
+      // rewrite via a temporary file to not lose rows if interrupted
+      auto tmp = std::filesystem::path(file) += ".tmp";
+      {
+        std::ofstream out(tmp);
+        CsvWriter csv(out);
+        print_csv_line(csv, "graph", header);
+        for (const std::string& row : rows) csv.line(row);
+      }
+      std::filesystem::rename(tmp, file);
+    }
+    m_out.open(file, std::ios::app);
+    if (std::filesystem::file_size(file) == 0) {
+      CsvWriter csv(m_out);
+      print_csv_line(csv, "graph", header);
+    }
+  }
+
+  // append the lines of csv, each prefixed with the graph name
+  void append(const std::string& graph, const std::string& csv) {
+    std::istringstream lines(csv);
+    std::string line;
+    {
+      CsvWriter out(m_out);
+      while (std::getline(lines, line)) {
+        print_csv_line(out, graph, line);
+      }
+    }
+    m_out.flush();
+  }
+
+ private:
+  std::ofstream m_out;
+};
+
+int main(int argc, char** argv) {
+  App app{
+      "Run a parameter sweep: generate a GIRG or Chung-Lu graph for each "
+      "combination of parameters in the grid file and compute its stats, "
+      "degree distributions and joint histogram, all in one process.  The "
+      "results are directly appended to merged csv files (as created by "
+      "merge_results).  Graphs that already appear in the "
+      "attribute files are skipped, such that an interrupted sweep can simply "
+      "be restarted (the rows of unfinished graphs are removed from the csv "
+      "files)."};
+
+  std::filesystem::path grid_file;
+  app.arg(grid_file, "grid_file",
+          "File containing the parameter grid.  Each line has the form "
+          "`key: value1 value2 ...` where the keys are model (girg or cl), n, "
+          "deg, dim, ple, T, sigma and seed.");
+
+  std::string output_dir = "output_data/sweep";
+  app.arg(output_dir, "--output_dir",
+          "Directory for the merged csv files (default: output_data/sweep).");
+
+  unsigned nr_threads = omp_get_max_threads();
+  app.arg(nr_threads, "--threads",
+          "Number of jobs running in parallel (default: number of cores).");
+
+  unsigned nr_buckets = 21;
+  app.arg(nr_buckets, "--nr_buckets",
+          "The number of buckets for the joint histogram and the restricted "
+          "edge endpoint degree distributions (default: 21).");
+
+  std::vector<unsigned> buckets = {0, 5, 10, 15, 20};
+  app.arg_list(buckets, "--buckets",
+               "The buckets for the restricted edge endpoint degree "
+               "distributions (default: 0,5,10,15,20).");
+
+  bool coupled = false;
+  app.arg(coupled, "--coupled",
+          "Generate GIRGs that only differ in sigma from a common GIRG "
+          "supergraph (coupled graphs).  This is faster than generating them "
+          "independently.");
+
+  app.parse(argc, argv);
+
+  if (!valid_buckets(buckets, nr_buckets)) return 1;
+
+  auto jobs = read_grid(grid_file);
+
+  std::filesystem::create_directories(output_dir);
+  auto path = [&](const std::string& name) {
+    return std::filesystem::path(output_dir) / (name + ".csv");
+  };
+
+  // the attributes are written last for each graph -> graphs with
+  // attributes are complete
+  std::unordered_set<std::string> complete;
+  for (std::string model : {"girg", "cl"}) {
+    for (const std::string& row : merged_rows(path(model + "_attributes"))) {
+      complete.insert(graph_of(row));
+    }
+  }
+  std::erase_if(jobs,
+                [&](const Job& job) { return complete.contains(job.name()); });
+
+  MergedCsv stats(path("stats"), stats_header, complete);
+  MergedCsv degree_distr(path("degree_distr"), degree_distribution_header,
+                         complete);
+  MergedCsv joint_histogram(path("joint_histogram"), joint_histogram_header,
+                            complete);
+  std::map<std::string, MergedCsv> attributes;
+  for (std::string model : {"girg", "cl"}) {
+    attributes.try_emplace(model, path(model + "_attributes"),
+                           attribute_header(model), complete);
+  }
+
+  // group the jobs that are generated together (see generate_group()):
+  // jobs only differing in the seed share the weights; with --coupled,
+  // this includes GIRGs only differing in sigma
+  std::vector<std::vector<Job>> groups;
+  std::map<std::string, unsigned> group_of;
+  for (const Job& job : jobs) {
+    std::string key = job.name(!coupled || job.params.model != "girg", false);
+    if (!group_of.contains(key)) {
+      group_of[key] = groups.size();
+      groups.emplace_back();
+    }
+    groups[group_of[key]].push_back(job);
+  }
+
+  // largest graphs first to avoid stragglers at the end
+  std::stable_sort(groups.begin(), groups.end(),
+                   [](const std::vector<Job>& g1, const std::vector<Job>& g2) {
+                     return g1.front().params.n > g2.front().params.n;
+                   });
+
+  std::mutex output_mutex;
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nr_threads)
+  for (unsigned i = 0; i < groups.size(); ++i) {
+    // the jobs run in parallel -> each job itself runs sequentially
+    omp_set_num_threads(1);
+
+    const std::vector<Job>& group = groups[i];
+    std::vector<GeneratorParams> params;
+    for (const Job& job : group) params.push_back(job.params);
+    auto graphs = generate_group(params);
+
+    for (unsigned j = 0; j < group.size(); ++j) {
+      const Job& job = group[j];
+      EdgeList EL(std::move(graphs[j]), UNDIRECTED, false);
+
+      std::ostringstream stats_csv, degree_distr_csv, joint_histogram_csv,
+          attributes_csv;
+      print_stats(EL, stats_csv);
+      print_degree_distributions(EL, degree_distr_csv, nr_buckets, buckets);
+      print_joint_histogram(EL, joint_histogram_csv, nr_buckets);
+      print_attributes(job.params, attributes_csv);
+
+      std::lock_guard<std::mutex> lock(output_mutex);
+      std::string name = job.name();
+      stats.append(name, stats_csv.str());
+      degree_distr.append(name, degree_distr_csv.str());
+      joint_histogram.append(name, joint_histogram_csv.str());
+      attributes.at(job.params.model).append(name, attributes_csv.str());
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "doctest.h"
+#include "random.hpp"
+#include "random_graph.hpp"
+#include "types.hpp"
+
+// Positions of the vertices as a structure of arrays, i.e., the d-th
+// coordinate of vertex v is stored at index d * n + v.
+struct Positions {
+  Positions(const std::vector<std::vector<double>>& positions)
+      : n(positions.size()),
+        dim(positions.empty() ? 0 : positions[0].size()),
+        coords(std::size_t(n) * dim) {
+    for (Node v = 0; v < n; ++v) {
+      for (unsigned d = 0; d < dim; ++d) {
+        coords[std::size_t(d) * n + v] = positions[v][d];
+      }
+    }
+  }
+
+  double coord(Node v, unsigned d) const {
+    return coords[std::size_t(d) * n + v];
+  }
+
+  unsigned n;
+  unsigned dim;
+  std::vector<double> coords;
+};
+
+// distance of two vertices on the torus (maximum norm)
+inline double distance(const Positions& p, Node u, Node v) {
+  auto result = 0.0;
+  for (auto d = 0u; d < p.dim; ++d) {
+    auto dist = std::abs(p.coord(u, d) - p.coord(v, d));
+    dist = std::min(dist, 1.0 - dist);
+    result = std::max(result, dist);
+  }
+  return result;
+}
+
+// Samples the edges of an AGIRG directly, i.e., without generating a
+// GIRG supergraph first.  The weights have to be sorted decreasingly.
+// Vertices u < v are connected with probability min(1, (w_part /
+// dist^dim)^α) with weight part w_v^σ w_u^{min(1, ple - σ)} / W (for
+// T = 0: if dist^dim < w_part).
+//
+// As in the GIRG generator, the vertices are grouped into weight
+// layers (weights within a factor of 2) and the ground space is
+// recursively divided into cells.  For each pair of layers, there is
+// a level such that the cells have roughly the volume of the maximum
+// weight part.  Pairs of vertices in touching cells of this level
+// are checked one by one (type I), for pairs of non-touching cells,
+// an upper bound on the connection probability is used to jump
+// directly to the next candidate (type II).  This takes expected time
+// O(n + m) (for fixed dimension).  The result does not depend on the
+// number of threads.
+std::vector<Edge> agirg_edges(const std::vector<double>& weights,
+                              const Positions& positions, double ple,
+                              double sigma, double T, std::uint64_t seed);
+
+TEST_CASE("[AGIRG Sampler] threshold graph") {
+  auto check = [](unsigned n, unsigned dim, double ple, double sigma) {
+    RandomStream rng(17);
+    auto weights = power_law_weights(n, ple);
+    std::sort(weights.begin(), weights.end(), std::greater<double>());
+    double scale = 3 / weights[n - 1];
+    for (double& w : weights) w *= scale;
+    std::vector<std::vector<double>> coords(n, std::vector<double>(dim));
+    for (auto& p : coords) {
+      for (double& x : p) x = rng.uniform();
+    }
+    Positions positions(coords);
+
+    auto edges = agirg_edges(weights, positions, ple, sigma, 0, 1);
+    std::vector<Edge> expected;
+    double W = 0;
+    for (double w : weights) W += w;
+    for (Node u = 0; u < n; ++u) {
+      for (Node v = u + 1; v < n; ++v) {
+        double w_part = std::pow(weights[v], sigma) *
+                        std::pow(weights[u], std::min(1.0, ple - sigma)) / W;
+        if (std::pow(distance(positions, u, v), dim) < w_part) {
+          expected.push_back({u, v});
+        }
+      }
+    }
+    REQUIRE(edges.size() == expected.size());
+    for (unsigned i = 0; i < edges.size(); ++i) {
+      CHECK(edges[i].s == expected[i].s);
+      CHECK(edges[i].t == expected[i].t);
+    }
+  };
+
+  for (unsigned dim : {1, 2, 3}) {
+    for (double sigma : {0.2, 1.0, 1.8}) {
+      check(500, dim, 2.5, sigma);
+    }
+  }
+}
+
+TEST_CASE("[AGIRG Sampler] expected number of edges") {
+  unsigned n = 2000, dim = 2;
+  double ple = 2.5, sigma = 0.6, T = 0.5;
+  RandomStream rng(23);
+  auto weights = power_law_weights(n, ple);
+  std::sort(weights.begin(), weights.end(), std::greater<double>());
+  double scale = 3 / weights[n - 1];
+  for (double& w : weights) w *= scale;
+  std::vector<std::vector<double>> coords(n, std::vector<double>(dim));
+  for (auto& p : coords) {
+    for (double& x : p) x = rng.uniform();
+  }
+  Positions positions(coords);
+
+  double W = 0;
+  for (double w : weights) W += w;
+  double expected = 0;
+  for (Node u = 0; u < n; ++u) {
+    for (Node v = u + 1; v < n; ++v) {
+      double w_part = std::pow(weights[v], sigma) *
+                      std::pow(weights[u], std::min(1.0, ple - sigma)) / W;
+      double dist_part = std::pow(distance(positions, u, v), dim);
+      expected += std::min(1.0, std::pow(w_part / dist_part, 1 / T));
+    }
+  }
+
+  // average over a few samples
+  double sampled = 0;
+  for (unsigned seed = 0; seed < 5; ++seed) {
+    sampled += agirg_edges(weights, positions, ple, sigma, T, seed).size();
+  }
+  CHECK(sampled / 5 == doctest::Approx(expected).epsilon(0.03));
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "edge_list.hpp"
+
+// The different evaluations of a graph as csv output.  They are
+// shared by the command line tools that read a graph from a file and
+// the ones that directly evaluate a freshly generated graph.
+
+inline const std::string stats_header =
+    "type,n,n1,n2,m,source_type,target_type,pearson,spearman,kendall_tau_a,"
+    "kendall_tau_b,kendall_tau_simple,concordant,discordant,ties_x,ties_y,"
+    "ties_both";
+
+inline const std::string degree_distribution_header =
+    "degree,frequency,edge_endpoints,nr_buckets,bucket,neighbor_deg_lb,"
+    "neighbor_deg_ub";
+
+inline const std::string joint_histogram_header =
+    "lb_x,ub_x,center_x,lb_y,ub_y,center_y,count,nr_buckets,compl_cumul";
+
+inline const std::string joint_degree_distr_header =
+    "degree_s,degree_t,frequency";
+
+inline const std::string edge_degrees_header = "source,target";
+
+// Output format of the large tables (joint degree distribution and
+// edge degrees): csv, or the columnar binary format of
+// binary_table.hpp (plain or delta encoded), whose schema contains
+// the column names of the csv header.
+enum TableFormat { CSV, BINARY, COMPRESSED };
+
+inline const std::vector<std::string> table_format_names = {
+    "csv", "binary", "compressed"};
+
+inline TableFormat table_format(const std::string& name) {
+  return name == "binary" ? BINARY : name == "compressed" ? COMPRESSED : CSV;
+}
+
+// basic stats and assortativity coefficients; one line for each
+// combination of degree types that makes sense for the graph type
+void print_stats(const EdgeList& EL, std::ostream& out);
+
+// Degree distribution as pairs of degree and frequency.  With
+// edge_endpoints, each vertex is counted once for each occurrence as
+// an endpoint of an edge, restricted to endpoints whose neighbor lies
+// in the given bucket (out of nr_buckets logarithmic buckets).
+void print_degree_distribution(const EdgeList& EL, std::ostream& out,
+                               bool edge_endpoints = false,
+                               unsigned nr_buckets = 1, unsigned bucket = 0);
+
+// The edge endpoint variant of the degree distribution restricted to
+// each of the given buckets (in this order).  The output is the same
+// as calling print_degree_distribution() for each bucket, but the
+// edges are scanned only once for all buckets.  The buckets have to be
+// below nr_buckets.
+void print_bucketed_degree_distributions(const EdgeList& EL, std::ostream& out,
+                                         unsigned nr_buckets,
+                                         const std::vector<unsigned>& buckets);
+
+// Whether every bucket is below nr_buckets (otherwise, an error is
+// printed); for checking the buckets passed on the command line.
+bool valid_buckets(const std::vector<unsigned>& buckets, unsigned nr_buckets);
+
+// All degree distributions used in the experiments: the plain degree
+// distribution, the edge endpoint variant, and the edge endpoint
+// variant restricted to each of the given buckets.
+void print_degree_distributions(const EdgeList& EL, std::ostream& out,
+                                unsigned nr_buckets,
+                                const std::vector<unsigned>& buckets);
+
+// The degree points used by the joint degree distribution: sum of in-
+// and out-degree for both endpoints (each undirected edge yields a
+// point for each orientation), or out- and in-degree for bipartite
+// graphs.
+std::vector<Point> joint_degree_points(const EdgeList& EL);
+
+// joint degree distribution aggregated into logarithmic buckets
+void print_joint_histogram(const EdgeList& EL, std::ostream& out,
+                           unsigned nr_buckets,
+                           bool complementary_cumulative = false);
+
+// the same for precomputed joint degree points
+void print_joint_histogram(const std::vector<Point>& points,
+                           std::ostream& out, unsigned nr_buckets,
+                           bool complementary_cumulative = false);
+
+// The joint histograms for each combination of the given numbers of
+// buckets and variants (plain or complementary cumulative).  The
+// graph is scanned only once for building the exact joint degree
+// table; the histograms are derived from it.
+void print_joint_histograms(const EdgeList& EL, std::ostream& out,
+                            const std::vector<unsigned>& nr_buckets,
+                            const std::vector<bool>& complementary_cumulative);
+
+// Joint degree distribution: the frequency of each pair of degrees
+// (sorted by the degrees).
+void print_joint_degree_distr(const std::vector<Point>& points,
+                              std::ostream& out, TableFormat format = CSV);
+
+// the degrees of the endpoints of each edge
+void print_edge_degrees(const std::vector<Point>& points, std::ostream& out,
+                        TableFormat format = CSV);
@@ -2,11 +2,25 @@
 
 #include <cstdlib>
 #include <filesystem>
+#include <functional>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "CLI11.hpp"
+#include "doctest.h"
 #include "random.hpp"
 
+// Replaces the placeholder (e.g., "{seed}") in a file name by the
+// value (if the name contains the placeholder).
+inline std::string fill_placeholder(std::string file,
+                                    const std::string& placeholder,
+                                    const std::string& value) {
+  auto pos = file.find(placeholder);
+  if (pos != std::string::npos) file.replace(pos, placeholder.size(), value);
+  return file;
+}
+
 class App {
  public:
   App(std::string app_name) : cli_app(app_name) {}
@@ -31,6 +45,15 @@ class App {
   auto arg(std::filesystem::path& variable, const std::string& name,
            const std::string& description);
 
+  // Add a comma separated list argument (e.g., `--seeds 1,2,3`).  Each
+  // occurrence takes exactly one token, such that the list can be
+  // followed by positional arguments (a CLI11 vector option would
+  // swallow them).  The validator is applied to each element.
+  template <typename T>
+  auto arg_list(std::vector<T>& variable, const std::string& name,
+                const std::string& description,
+                CLI::Validator validator = CLI::Validator());
+
   // special header flags
   void arg_header(const std::string& header) {
     m_no_header = false;
@@ -41,6 +64,12 @@ class App {
                      "Only print the results and not the csv-header.");
   }
 
+  // suppresses the csv-header if skip() holds after parsing (e.g., for
+  // binary output)
+  void skip_header_if(const std::function<bool()>& skip) {
+    m_skip_header = skip;
+  }
+
   // special seed flag
   void arg_seed() {
     m_seed_used = true;
@@ -61,7 +90,7 @@ class App {
       Random::set_seed(m_seed);
     }
 
-    if (!m_no_header) {
+    if (!m_no_header && !(m_skip_header && m_skip_header())) {
       std::cout << m_header << std::endl;
     }
     if (m_only_header) {
@@ -79,6 +108,7 @@ class App {
   std::string m_header = "";
   bool m_only_header = false;
   bool m_no_header = true;
+  std::function<bool()> m_skip_header;
 
   bool m_seed_used = false;
   unsigned m_seed;
@@ -124,3 +154,68 @@ auto App::arg(std::filesystem::path& variable, const std::string& name,
               const std::string& description) {
   return base_arg(variable, name, description)->check(CLI::ExistingFile);
 }
+
+template <typename T>
+auto App::arg_list(std::vector<T>& variable, const std::string& name,
+                   const std::string& description, CLI::Validator validator) {
+  auto parse_list = [&variable, validator, name](const CLI::results_t& res) {
+    std::vector<T> values;
+    std::istringstream list(res.front());
+    std::string element;
+    while (std::getline(list, element, ',')) {
+      std::string error = validator(element);
+      if (!error.empty()) throw CLI::ValidationError(name, error);
+      T value;
+      if (!CLI::detail::lexical_cast(element, value)) {
+        throw CLI::ConversionError(element, name);
+      }
+      values.push_back(value);
+    }
+    variable = values;
+    return true;
+  };
+  auto opt = cli_app.add_option(name, CLI::callback_t(parse_list),
+                                description);
+  opt->type_name(std::string(CLI::detail::type_name<T>()) + " LIST");
+  opt->type_size(1);
+  opt->expected(1);
+  return opt;
+}
+
+TEST_CASE("[App] list arguments") {
+  std::vector<unsigned> nr_buckets = {21};
+  std::vector<double> sigmas;
+  std::string file;
+  unsigned n = 0;
+  App app{"test"};
+  app.arg(file, "file", "file");
+  app.arg_list(nr_buckets, "--nr_buckets", "list");
+  app.arg_list(sigmas, "--sigmas", "list", CLI::Range(0.0, 2.0));
+  app.arg(n, "-n", "number");
+
+  auto parse = [&](const std::string& args) {
+    nr_buckets = {21};
+    sigmas = {};
+    file = "";
+    n = 0;
+    app.cli_app.parse(args);
+  };
+
+  // the list does not swallow the following positional argument
+  parse("--nr_buckets 21 g.txt");
+  CHECK(nr_buckets == std::vector<unsigned>{21});
+  CHECK(file == "g.txt");
+  parse("--nr_buckets=21 g.txt");
+  CHECK(nr_buckets == std::vector<unsigned>{21});
+  CHECK(file == "g.txt");
+  parse("--nr_buckets 5,10 g.txt -n 3 --sigmas 0.5,1");
+  CHECK(nr_buckets == std::vector<unsigned>{5, 10});
+  CHECK(sigmas == std::vector<double>{0.5, 1});
+  CHECK(file == "g.txt");
+  CHECK(n == 3);
+  parse("g.txt");
+  CHECK(nr_buckets == std::vector<unsigned>{21});
+
+  CHECK_THROWS_AS(parse("--sigmas 0.5,3 g.txt"), CLI::ValidationError);
+  CHECK_THROWS_AS(parse("--nr_buckets 5,x g.txt"), CLI::ConversionError);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "doctest.h"
+#include "types.hpp"
+
+// Compact binary format for lexicographically sorted edge lists, used
+// for graphs that are too large for the text format.  The file starts
+// with the magic bytes "\0EDGESDV" (the zero byte distinguishes it from
+// text files), followed by one byte for the graph type and the number
+// of vertices (8 bytes, little endian).  Then, each edge is stored as
+// two varints (7 bits per byte, the highest bit marks that more bytes
+// follow): the difference of the source to the previous source and,
+// for the same source, the difference of the target to the previous
+// target, and otherwise the zigzag encoded difference of the target to
+// the source.  An edge of a Chung-Lu graph takes 3 to 4 bytes (e.g.,
+// 2.9 for n = 10^5, 3.4 for n = 10^6 and 3.8 for n = 10^7), growing
+// slowly with the number of vertices.
+class BinaryEdgeWriter {
+ public:
+  BinaryEdgeWriter(std::ostream& out, GraphType type, std::uint64_t n);
+
+  // Appends the edges, which have to continue the lexicographic order
+  // of the edges written so far (without duplicates).
+  void write(const std::vector<Edge>& edges);
+
+  // number of edges written so far
+  std::uint64_t m() const { return m_m; }
+
+ private:
+  std::ostream& m_out;
+  std::string m_buffer;
+  Edge m_prev{0, 0};
+  std::uint64_t m_m = 0;
+};
+
+// Reads the edges of the binary format one by one.  Input that does
+// not start with the magic bytes and a complete header, or that ends
+// within an edge, is reported as an error (and exits).
+class BinaryEdgeReader {
+ public:
+  BinaryEdgeReader(std::istream& in);
+
+  GraphType type() const { return m_type; }
+  std::uint64_t n() const { return m_n; }
+
+  // reads the next edge; returns false at the end of the input
+  bool next(Edge& edge);
+
+ private:
+  std::uint64_t read_varint();
+
+  std::istream& m_in;
+  GraphType m_type;
+  std::uint64_t m_n;
+  Edge m_prev{0, 0};
+  bool m_first = true;
+};
+
+// Whether the input is in the binary format (without consuming
+// anything).  Only the first magic byte is checked, as putting back
+// more than one byte is not supported by every stream (e.g., pipes);
+// a text file never starts with a zero byte, and BinaryEdgeReader
+// checks the remaining magic bytes.
+inline bool is_binary_edges(std::istream& in) { return in.peek() == '\0'; }
+
+TEST_CASE("[Binary Edges] round trip") {
+  // sorted, but with targets smaller and larger than the sources,
+  // large ids and long gaps
+  std::vector<Edge> edges = {{0, 0},          {0, 5},          {0, 6},
+                             {3, 1},          {3, 4000000000}, {7, 2},
+                             {7, 3},          {1000000, 999999},
+                             {4000000000, 3}, {4000000000, 4294967295}};
+  std::stringstream stream;
+  BinaryEdgeWriter writer(stream, DIRECTED, 4294967296);
+  // written in two parts
+  writer.write({edges.begin(), edges.begin() + 4});
+  writer.write({edges.begin() + 4, edges.end()});
+  CHECK(writer.m() == edges.size());
+
+  CHECK(is_binary_edges(stream));
+  BinaryEdgeReader reader(stream);
+  CHECK(reader.type() == DIRECTED);
+  CHECK(reader.n() == 4294967296);
+  Edge e;
+  for (const Edge& expected : edges) {
+    REQUIRE(reader.next(e));
+    CHECK(e.s == expected.s);
+    CHECK(e.t == expected.t);
+  }
+  CHECK(!reader.next(e));
+
+  // text files are not mistaken for the binary format
+  std::istringstream text{"% sym unweighted\n1 2\n"};
+  CHECK(!is_binary_edges(text));
+}
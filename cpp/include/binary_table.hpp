@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <ostream>
+#include <span>
+#include <sstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "doctest.h"
+
+// Columnar binary format for large tables of natural numbers (e.g.,
+// the edge degrees), which is much faster to write and to read than
+// csv.  The file starts with the magic bytes "\0COLUMNS", the number
+// of rows (8 bytes) and the number of columns (1 byte).  Then, the
+// schema lists for each column its name (1 byte for the length,
+// followed by the characters), the width of its values (1 byte, the
+// number of bytes needed for the largest value, between 1 and 8), the
+// encoding (1 byte), and the size of its data in bytes (8 bytes).  The
+// data of the columns follows, one column after the other.  A plain
+// column stores each value in width bytes.  A varint column stores
+// each value as a varint (see varint.hpp), and a delta column stores
+// the zigzag encoded difference of each value to the previous value
+// (the first to 0) as a varint, which takes one or two bytes for
+// sorted or repeated values.  All numbers are little endian.
+class BinaryTableWriter {
+ public:
+  enum Encoding : std::uint8_t { PLAIN = 0, DELTA = 1, VARINT = 2 };
+
+  // Table with plain columns or, if compress is set, each column with
+  // the smaller of the two varint encodings.
+  explicit BinaryTableWriter(bool compress);
+
+  // Adds a column; all columns need the same number of values.  The
+  // values are not copied, i.e., they have to stay alive until
+  // write().
+  void add_column(const std::string& name,
+                  std::span<const std::uint32_t> values);
+  void add_column(const std::string& name,
+                  std::span<const std::uint64_t> values);
+
+  // Writes the schema followed by the columns.  The columns are
+  // encoded in chunks, which are processed in parallel and streamed to
+  // the output batch by batch.
+  void write(std::ostream& out) const;
+
+ private:
+  using Values = std::variant<std::span<const std::uint32_t>,
+                              std::span<const std::uint64_t>>;
+  struct Column {
+    std::string name;
+    Values values;
+  };
+
+  bool m_compress;
+  std::vector<Column> m_columns;
+};
+
+TEST_CASE("[Binary Table] format") {
+  auto bytes = [](std::initializer_list<unsigned> values) {
+    std::string result;
+    for (unsigned v : values) result.push_back(char(v));
+    return result;
+  };
+  std::string header = bytes({0, 'C', 'O', 'L', 'U', 'M', 'N', 'S',  //
+                              3, 0, 0, 0, 0, 0, 0, 0,                //
+                              3});
+
+  std::vector<std::uint32_t> a = {1, 2, 300}, b = {200, 200, 200};
+  std::vector<std::uint64_t> c = {5, 1ull << 32, 3};
+  for (bool compress : {false, true}) {
+    BinaryTableWriter table(compress);
+    table.add_column("a", a);
+    table.add_column("bb", b);
+    table.add_column("c", c);
+    std::ostringstream out;
+    table.write(out);
+
+    std::string expected = header;
+    if (!compress) {
+      expected += bytes({1, 'a', 2, 0, 6, 0, 0, 0, 0, 0, 0, 0,       //
+                         2, 'b', 'b', 1, 0, 3, 0, 0, 0, 0, 0, 0, 0,  //
+                         1, 'c', 5, 0, 15, 0, 0, 0, 0, 0, 0, 0,      //
+                         1, 0, 2, 0, 44, 1,                          //
+                         200, 200, 200,                              //
+                         5, 0, 0, 0, 0, 0, 0, 0, 0, 1, 3, 0, 0, 0, 0});
+    } else {
+      // a: varint (1, 2, 300; delta is not smaller); bb: delta (+200,
+      // 0, 0); c: varint (5, 2^32, 3)
+      expected += bytes({1, 'a', 2, 2, 4, 0, 0, 0, 0, 0, 0, 0,       //
+                         2, 'b', 'b', 1, 1, 4, 0, 0, 0, 0, 0, 0, 0,  //
+                         1, 'c', 5, 2, 7, 0, 0, 0, 0, 0, 0, 0,       //
+                         1, 2, 0xac, 0x02,                           //
+                         0x90, 0x03, 0, 0,                           //
+                         5, 0x80, 0x80, 0x80, 0x80, 0x10, 3});
+    }
+    CHECK(out.str() == expected);
+  }
+}
+
+TEST_CASE("[Binary Table] chunks and R fixture") {
+  // many chunks: plain and both varint encodings
+  std::vector<std::uint32_t> sorted(300000), scattered(300000);
+  for (std::uint32_t i = 0; i < sorted.size(); ++i) {
+    sorted[i] = i / 3;
+    scattered[i] = (i * 2654435761u) >> (i % 32);
+  }
+  for (bool compress : {false, true}) {
+    BinaryTableWriter table(compress);
+    table.add_column("sorted", sorted);
+    table.add_column("scattered", scattered);
+    std::ostringstream out;
+    table.write(out);
+
+    // decode
+    std::string data = out.str();
+    std::size_t pos = 17;
+    auto read_fixed = [&](unsigned width) {
+      std::uint64_t x = 0;
+      for (unsigned i = 0; i < width; ++i) {
+        x |= std::uint64_t(std::uint8_t(data[pos++])) << (8 * i);
+      }
+      return x;
+    };
+    std::vector<std::pair<unsigned, unsigned>> schema;
+    for (unsigned column = 0; column < 2; ++column) {
+      pos += 1 + std::uint8_t(data[pos]);
+      unsigned width = read_fixed(1), encoding = read_fixed(1);
+      read_fixed(8);
+      schema.push_back({width, encoding});
+    }
+    for (const auto* values : {&sorted, &scattered}) {
+      auto [width, encoding] = schema[values == &sorted ? 0 : 1];
+      CHECK(encoding == (!compress ? 0 : values == &sorted ? 1 : 2));
+      std::uint64_t prev = 0;
+      for (std::uint32_t expected : *values) {
+        std::uint64_t x = 0;
+        if (encoding == 0) {
+          x = read_fixed(width);
+        } else {
+          for (unsigned shift = 0;; shift += 7) {
+            auto byte = std::uint8_t(data[pos++]);
+            x |= std::uint64_t(byte & 0x7f) << shift;
+            if (byte < 0x80) break;
+          }
+          if (encoding == 1) x = prev += (x >> 1) ^ -(x & 1);
+        }
+        REQUIRE(x == expected);
+      }
+    }
+    CHECK(pos == data.size());
+  }
+
+  // The fixtures for R/test/read_binary_table.R: 32-bit values of
+  // width 1, 3 and 4 (including values of at least 2^31), 64-bit
+  // values, and repeated values (delta encoded when compressed).
+  std::vector<std::uint32_t> small = {0, 1, 255, 7};
+  std::vector<std::uint32_t> medium = {65536, 70000, 1, 16777215};
+  std::vector<std::uint32_t> large = {4294967295u, 2147483648u, 3, 65536};
+  std::vector<std::uint64_t> wide = {(1ull << 40) + 5, 0, 1ull << 33, 12};
+  std::vector<std::uint32_t> repeated = {1000, 1000, 1001, 1000};
+  auto fixture_dir =
+      std::filesystem::path(__FILE__).parent_path() / "../../R/test";
+  for (bool compress : {false, true}) {
+    BinaryTableWriter table(compress);
+    table.add_column("small", small);
+    table.add_column("medium", medium);
+    table.add_column("large", large);
+    table.add_column("wide", wide);
+    table.add_column("repeated", repeated);
+    std::ostringstream out;
+    table.write(out);
+    std::ifstream fixture(
+        fixture_dir / (compress ? "compressed.bin" : "binary.bin"),
+        std::ios::binary);
+    CHECK(out.str() == std::string(std::istreambuf_iterator<char>(fixture),
+                                   std::istreambuf_iterator<char>()));
+  }
+}
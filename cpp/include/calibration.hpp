@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include "doctest.h"
+#include "weights.hpp"
+
+// Groups decreasingly sorted weights into classes of consecutive
+// vertices with similar weights, such that the largest weight of a
+// class is at most max_ratio times its smallest weight.  Sums over
+// all pairs of vertices can then be approximated by sums over pairs
+// of classes.
+class WeightClasses {
+ public:
+  WeightClasses(const std::vector<double>& weights, double max_ratio = 1.01);
+
+  // number of classes
+  unsigned size() const { return m_begin.size() - 1; }
+
+  // the vertices begin(c), ..., end(c) - 1 form class c
+  unsigned begin(unsigned c) const { return m_begin[c]; }
+  unsigned end(unsigned c) const { return m_begin[c + 1]; }
+  unsigned count(unsigned c) const { return end(c) - begin(c); }
+
+  // for each class, the sum of the given values of its vertices
+  std::vector<double> sums(const std::vector<double>& values) const;
+
+  // for each class, the sum of the weights of its vertices to the
+  // power of exponent (without storing the powers of all weights)
+  std::vector<double> power_sums(const std::vector<double>& weights,
+                                 double exponent) const;
+
+ private:
+  std::vector<unsigned> m_begin;
+};
+
+// Finds x > 0 with f(x) = target for an increasing function f,
+// starting with the guess x.  The root is first bracketed and then
+// approximated with the secant method (Illinois variant) until f(x)
+// is within a relative error of rel_tol from the target.  Exits with
+// an error if the target cannot be bracketed (f stays below or above
+// it for x scaled by up to 2^256).
+double find_root(const std::function<double(double)>& f, double target,
+                 double x = 1.0, double rel_tol = 1e-6);
+
+// Expected number of edges of an AGIRG with the given decreasingly
+// sorted weights, i.e., the sum over all pairs u < v of the
+// probability that u and v are connected (averaged over the uniformly
+// random positions).  The estimation works on weight classes and
+// takes time quadratic in the number of classes.
+class AgirgEdgeEstimator {
+ public:
+  AgirgEdgeEstimator(const std::vector<double>& weights, double ple,
+                     double sigma, unsigned dim, double T,
+                     double max_ratio = 1.01);
+
+  // expected number of edges when the weight part of each connection
+  // probability is multiplied by factor
+  double operator()(double factor) const;
+
+ private:
+  // connection probability for the given weight part (times 2^dim),
+  // i.e., the probability that a pair of vertices is connected when
+  // its weight part is x and the positions are random
+  double probability(double x) const;
+
+  WeightClasses m_classes;
+  std::vector<double> m_avg_heavy;
+  std::vector<double> m_avg_sigma;
+  double m_normalization;
+  double m_alpha;
+};
+
+// Expected number of edges of a Chung-Lu graph with the given
+// decreasingly sorted weights and their powers, i.e., the sum over
+// all pairs u < v of min(1, factor w_u^min(1, τ - σ) w_v^σ / W).  The
+// estimation works on weight classes and takes time linear in the
+// number of classes.  It is exact for pairs in different classes whose
+// probability is not capped at 1; the remaining error shrinks
+// quadratically with max_ratio - 1 (below 10^-5 for 1.01 and below
+// 10^-7 for 1.001), i.e., max_ratio = 1 + ε is enough for a relative
+// error of ε.
+class ChungLuEdgeEstimator {
+ public:
+  ChungLuEdgeEstimator(const std::vector<double>& weights,
+                       const SigmaWeights& powers, double max_ratio = 1.01);
+
+  // the same, but computing the powers on the fly
+  ChungLuEdgeEstimator(const std::vector<double>& weights, double ple,
+                       double sigma, double max_ratio = 1.01);
+
+  // expected number of edges for the given factor
+  double operator()(double factor) const;
+
+  // sum of w^σ over all vertices
+  double light_sum() const { return m_light_prefix.back(); }
+
+ private:
+  WeightClasses m_classes;
+  std::vector<double> m_avg_heavy;
+  std::vector<double> m_avg_light;
+  // m_light_prefix[c] = sum of w^σ over the classes 0, ..., c - 1
+  std::vector<double> m_light_prefix;
+  double m_weight_sum;
+};
+
+TEST_CASE("[Calibration] find root") {
+  auto sqr = [](double x) { return x * x; };
+  CHECK(find_root(sqr, 2.0, 1.0, 1e-12) == doctest::Approx(std::sqrt(2.0)));
+  CHECK(find_root(sqr, 1e6, 1e-3, 1e-12) == doctest::Approx(1e3));
+}
+
+TEST_CASE("[Calibration] AGIRG edge estimation") {
+  // weights with many duplicates
+  std::vector<double> weights;
+  for (unsigned i = 0; i < 60; ++i) {
+    weights.push_back(std::pow(2.0, 4 - i / 12));
+  }
+  WeightClasses classes(weights);
+  CHECK(classes.size() == 5);
+  CHECK(classes.count(0) == 12);
+
+  double ple = 2.5, sigma = 0.6;
+  unsigned dim = 2;
+  double W = 0;
+  for (double w : weights) W += w;
+
+  for (double T : {0.0, 0.5, 1.0}) {
+    double alpha = T > 0 ? 1 / T : 0;
+    double factor = 0.3;
+    double expected = 0;
+    for (unsigned u = 0; u < weights.size(); ++u) {
+      for (unsigned v = u + 1; v < weights.size(); ++v) {
+        double q = factor * std::pow(2, dim) *
+                   std::pow(weights[u], std::min(1.0, ple - sigma)) *
+                   std::pow(weights[v], sigma) / W;
+        // numerical integration over the distance part, which is
+        // uniformly distributed in [0, 2^{-dim}]
+        double p = 0;
+        unsigned steps = 100000;
+        for (unsigned i = 0; i < steps; ++i) {
+          double dist_part = (i + 0.5) / steps;
+          p += T == 0 ? (dist_part < q)
+                      : std::min(1.0, std::pow(q / dist_part, alpha));
+        }
+        expected += p / steps;
+      }
+    }
+    AgirgEdgeEstimator estimator(weights, ple, sigma, dim, T);
+    CHECK(estimator(factor) == doctest::Approx(expected).epsilon(0.001));
+  }
+}
+
+TEST_CASE("[Calibration] Chung-Lu edge estimation") {
+  unsigned n = 3000;
+  double ple = 2.3;
+  auto weights = power_law_weights(n, ple);
+  double W = sum(weights);
+  for (double sigma : {0.3, 1.0, 1.7}) {
+    SigmaWeights powers(weights, ple, sigma);
+    ChungLuEdgeEstimator estimator(weights, powers);
+    ChungLuEdgeEstimator estimator_on_the_fly(weights, ple, sigma);
+    CHECK(estimator.light_sum() == doctest::Approx(sum(powers.light)));
+    // small factors: no probability is capped; large factors: many are
+    for (double factor : {1.0, 100.0, 10000.0}) {
+      double expected = 0;
+      for (unsigned u = 0; u < n; ++u) {
+        for (unsigned v = u + 1; v < n; ++v) {
+          expected +=
+              std::min(1.0, factor * powers.heavy[u] * powers.light[v] / W);
+        }
+      }
+      CHECK(estimator(factor) == doctest::Approx(expected).epsilon(0.002));
+      ChungLuEdgeEstimator fine(weights, powers, 1 + 1e-6);
+      CHECK(fine(factor) == doctest::Approx(expected).epsilon(1e-6));
+      CHECK(estimator_on_the_fly(factor) ==
+            doctest::Approx(estimator(factor)));
+    }
+  }
+}
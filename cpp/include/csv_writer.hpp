@@ -0,0 +1,101 @@
+#pragma once
+
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "doctest.h"
+
+// Buffered writer for csv output.  Numbers are formatted with
+// std::to_chars (doubles in the shortest form that reads back to the
+// same value) instead of the locale dependent stream formatting, and
+// the output is passed to the stream in large chunks.  The buffer is
+// flushed when it is full, by flush(), and on destruction.
+class CsvWriter {
+ public:
+  explicit CsvWriter(std::ostream& out, char separator = ',');
+  ~CsvWriter();
+
+  CsvWriter(const CsvWriter&) = delete;
+  void operator=(const CsvWriter&) = delete;
+
+  // writes the values separated by the separator and ends the line
+  template <typename T, typename... Args>
+  void line(const T& first, const Args&... rest) {
+    write(first);
+    ((put(m_separator), write(rest)), ...);
+    put('\n');
+  }
+
+  // writes a single value (without separator)
+  template <std::integral T>
+  void write(T x) {
+    reserve(max_number_length);
+    m_size = std::to_chars(end(), end() + max_number_length, x).ptr -
+             m_buffer.data();
+  }
+  void write(bool x);
+  void write(double x);
+  void write(char c);
+  void write(const char* s);
+  void write(std::string_view s);
+
+  // passes the buffered output to the stream
+  void flush();
+
+ private:
+  // longest output of to_chars for 64-bit integers and doubles
+  static constexpr std::size_t max_number_length = 32;
+
+  void put(char c) {
+    reserve(1);
+    m_buffer[m_size++] = c;
+  }
+  // makes sure that the buffer has room for n more characters
+  void reserve(std::size_t n) {
+    if (m_buffer.size() - m_size < n) flush();
+  }
+  char* end() { return m_buffer.data() + m_size; }
+
+  std::ostream& m_out;
+  char m_separator;
+  std::vector<char> m_buffer;
+  std::size_t m_size = 0;
+};
+
+template <typename... Args>
+void print_csv_line(CsvWriter& out, const Args&... args) {
+  out.line(args...);
+}
+
+TEST_CASE("[CsvWriter] formatting") {
+  std::ostringstream out;
+  {
+    CsvWriter csv(out);
+    print_csv_line(csv, 0u, -12, 18446744073709551615ull, true, false);
+    print_csv_line(csv, 0.1, 2.5, 1e300, -0.0, 1.0 / 3.0);
+    print_csv_line(csv, "undirected", std::string("sum"), 'x');
+    // longer than the buffer
+    csv.line(std::string(3 << 20, 'a'));
+  }
+  std::string expected = "0,-12,18446744073709551615,1,0\n"
+                         "0.1,2.5,1e+300,-0,0.3333333333333333\n"
+                         "undirected,sum,x\n" +
+                         std::string(3 << 20, 'a') + "\n";
+  CHECK(out.str() == expected);
+
+  std::ostringstream edges;
+  {
+    CsvWriter csv(edges, ' ');
+    csv.line(1u, 2u);
+    csv.line(3u, 4u);
+    csv.flush();
+    CHECK(edges.str() == "1 2\n3 4\n");
+  }
+  CHECK(edges.str() == "1 2\n3 4\n");
+}
@@ -11,7 +11,17 @@
 
 class EdgeList {
  public:
-  EdgeList(std::istream& input);
+  // Reads the edges in the text format (optionally with KONECT header)
+  // or in the binary format of binary_edges.hpp.  Without
+  // with_neighbors, only the edges and degrees are stored (which
+  // suffices for all evaluations), but not the neighbor lists.
+  EdgeList(std::istream& input, bool with_neighbors = true);
+
+  // Builds the edge list directly from edges that are already in
+  // memory (e.g., a freshly generated graph).  Node ids are expected
+  // to start at 0.
+  EdgeList(std::vector<Edge> edges, GraphType type = UNDIRECTED,
+           bool with_neighbors = true);
 
   GraphType type() const { return m_graph_type; }
 
@@ -36,7 +46,7 @@ class EdgeList {
   // degree of a vertex
   unsigned deg(DegType type, Node v) const;
 
-  // neighbors of a vertex
+  // neighbors of a vertex (only if constructed with_neighbors)
   const std::vector<Node>& neigbors(DegType type, Node v) const;
 
   // edges; note that for BIPARTITE, the same node id can be used for
@@ -45,6 +55,7 @@ class EdgeList {
 
  private:
   void check_configuration(DegType source_type, DegType target_type) const;
+  void add_edge(Node s, Node t);
   unsigned& deg_mut(DegType type, Node v);
   std::vector<Node>& neighbors(DegType type, Node v);
 
@@ -52,6 +63,7 @@ class EdgeList {
   std::vector<Edge> m_edges;
   std::vector<std::vector<unsigned>> m_deg;
   std::vector<std::vector<std::vector<Node>>> m_neighbors;
+  bool m_with_neighbors = true;
 };
 
 TEST_CASE("[Edge List] Undirected Graphs") {
@@ -120,6 +132,42 @@ TEST_CASE("[Edge List] Undirected Graphs") {
   check(input_el_format);
 }
 
+TEST_CASE("[Edge List] In-memory edges") {
+  std::istringstream input{
+      "0 1\n"
+      "1 2\n"
+      "0 2\n"
+      "2 3\n"};
+  EdgeList EL_parsed(input);
+  EdgeList EL({{0, 1}, {1, 2}, {0, 2}, {2, 3}});
+
+  CHECK(EL.type() == UNDIRECTED);
+  CHECK(EL.n() == EL_parsed.n());
+  CHECK(EL.m() == EL_parsed.m());
+  for (Node v = 0; v < EL.n(); ++v) {
+    CHECK(EL.deg(SUM, v) == EL_parsed.deg(SUM, v));
+  }
+
+  EdgeList EL_dir({{0, 1}, {1, 2}, {0, 2}, {2, 3}}, DIRECTED);
+  CHECK(EL_dir.type() == DIRECTED);
+  CHECK(EL_dir.deg(OUT, 0) == 2);
+  CHECK(EL_dir.deg(IN, 2) == 2);
+
+  // degrees only (without neighbor lists)
+  EdgeList EL_deg({{0, 1}, {1, 2}, {0, 2}, {2, 3}}, UNDIRECTED, false);
+  CHECK(EL_deg.n() == EL.n());
+  for (Node v = 0; v < EL.n(); ++v) {
+    CHECK(EL_deg.deg(SUM, v) == EL.deg(SUM, v));
+  }
+  auto points = EL.degree_points(SUM, SUM);
+  auto points_deg = EL_deg.degree_points(SUM, SUM);
+  REQUIRE(points.size() == points_deg.size());
+  for (unsigned i = 0; i < points.size(); ++i) {
+    CHECK(points[i].x == points_deg[i].x);
+    CHECK(points[i].y == points_deg[i].y);
+  }
+}
+
 TEST_CASE("[Edge Lists] Directed Graphs") {
   std::istringstream input{
       "% asym unweighted\n"
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "csv_writer.hpp"
+#include "girg.hpp"
+#include "random.hpp"
+#include "random_graph.hpp"
+#include "types.hpp"
+
+// Parameters of the random graph models that can be generated and
+// evaluated in one process (without writing the graph to disk in
+// between).  The model is either "girg" or "cl" (Chung-Lu); dim and T
+// are ignored for Chung-Lu graphs.
+struct GeneratorParams {
+  std::string model = "girg";
+  unsigned n = 100;
+  double deg = 15;
+  unsigned dim = 1;
+  double ple = 2.5;
+  double T = 0;
+  double sigma = 1;
+  unsigned seed = 0;
+};
+
+// csv header of the generator attributes (same as for the generators
+// `girg` and `chung_lu`)
+inline std::string attribute_header(const std::string& model) {
+  return model == "girg" ? "n,deg,dim,ple,T,alpha,sigma,seed"
+                         : "n,deg,ple,sigma,seed";
+}
+
+inline void print_attributes(const GeneratorParams& p, std::ostream& out) {
+  CsvWriter csv(out);
+  if (p.model == "girg") {
+    double alpha =
+        p.T > 0 ? 1 / p.T : std::numeric_limits<double>::infinity();
+    print_csv_line(csv, p.n, p.deg, p.dim, p.ple, p.T, alpha, p.sigma, p.seed);
+  } else {
+    print_csv_line(csv, p.n, p.deg, p.ple, p.sigma, p.seed);
+  }
+}
+
+// generate a graph; the result is the same as for the generators
+// `girg` and `chung_lu` with the same parameters and seed
+inline std::vector<Edge> generate(const GeneratorParams& p) {
+  Random::set_seed(p.seed);
+  if (p.model == "girg") {
+    return agirg_calibrated(p.n, p.ple, p.deg, p.dim, p.T, p.sigma);
+  }
+  return chung_lu(p.n, p.ple, p.deg, p.sigma);
+}
+
+// Generates the graphs for parameter sets that only differ in the
+// seed and (for GIRGs) in sigma.  The seed-independent weights (and
+// their calibration) are computed only once and the replicas for the
+// different seeds are generated in parallel (see for_each_seed()).
+// The GIRGs for the same seed are coupled (see agirg_coupled()); for
+// a single sigma, each graph is the same as the one generated by
+// generate().
+inline std::vector<std::vector<Edge>> generate_group(
+    const std::vector<GeneratorParams>& ps) {
+  const GeneratorParams& p = ps.front();
+  std::vector<double> sigmas;
+  std::vector<unsigned> seeds;
+  auto index = [](auto& values, auto value) {
+    auto it = std::find(values.begin(), values.end(), value);
+    if (it != values.end()) return std::size_t(it - values.begin());
+    values.push_back(value);
+    return values.size() - 1;
+  };
+  std::vector<std::pair<std::size_t, std::size_t>> seed_sigma;
+  for (const GeneratorParams& q : ps) {
+    seed_sigma.emplace_back(index(seeds, q.seed), index(sigmas, q.sigma));
+  }
+
+  // graphs[i][j]: seed i and sigma j
+  std::vector<std::vector<std::vector<Edge>>> graphs(seeds.size());
+  if (p.model == "girg") {
+    auto weights =
+        agirg_calibrated_weights(p.n, p.ple, p.deg, p.dim, p.T, sigmas);
+    for_each_seed(seeds,
+                  [&](std::size_t i) { graphs[i] = agirg_coupled(weights); });
+  } else {
+    ChungLuWeights weights(p.n, p.ple, p.deg, p.sigma);
+    for_each_seed(seeds,
+                  [&](std::size_t i) { graphs[i] = {chung_lu(weights)}; });
+  }
+
+  // a graph requested more than once is copied (moved on its last use)
+  std::vector<std::vector<Edge>> result;
+  for (auto it = seed_sigma.begin(); it != seed_sigma.end(); ++it) {
+    auto& graph = graphs[it->first][it->second];
+    if (std::find(it + 1, seed_sigma.end(), *it) != seed_sigma.end()) {
+      result.push_back(graph);
+    } else {
+      result.push_back(std::move(graph));
+    }
+  }
+  return result;
+}
@@ -10,15 +10,19 @@
 #include <unordered_set>
 #include <vector>
 
+#include <omp.h>
+
+#include "agirg_sampler.hpp"
+#include "calibration.hpp"
 #include "doctest.h"
 #include "girgs/Generator.h"
 #include "ipe.hpp"
 #include "random.hpp"
 #include "random_graph.hpp"
 #include "types.hpp"
+#include "weights.hpp"
 
-inline void print_graph(const std::vector<Edge>& E,
-                        const std::vector<std::vector<double>>& p,
+inline void print_graph(const std::vector<Edge>& E, const Positions& p,
                         const std::vector<double>& w,
                         const std::string& filename, double sigma) {
   IpeFile ipe(filename, 400, 40);
@@ -29,35 +33,33 @@ inline void print_graph(const std::vector<Edge>& E,
 
   ipe.start_group_with_clipping(0, 0, 1, 1);
   for (auto& e : E) {
-    std::vector<double> s_pos = p[e.s];
-    std::vector<std::vector<double>> t_cand_pos(0);
+    std::vector<double> s_pos = {p.coord(e.s, 0), p.coord(e.s, 1)};
+    std::vector<double> t_pos = {p.coord(e.t, 0), p.coord(e.t, 1)};
     std::vector<std::vector<double>> offsets;
     for (auto x : {-1.0, 0.0, 1.0}) {
       for (auto y : {-1.0, 0.0, 1.0}) {
         offsets.push_back({x, y});
-        t_cand_pos.push_back({p[e.t][0] + x, p[e.t][1] + y});
       }
     }
 
     std::vector<double> offset = *std::min_element(
         offsets.begin(), offsets.end(), [&](auto& o1, auto& o2) {
-          return sqr_dist(s_pos, {p[e.t][0] + o1[0], p[e.t][1] + o1[1]}) <
-                 sqr_dist(s_pos, {p[e.t][0] + o2[0], p[e.t][1] + o2[1]});
+          return sqr_dist(s_pos, {t_pos[0] + o1[0], t_pos[1] + o1[1]}) <
+                 sqr_dist(s_pos, {t_pos[0] + o2[0], t_pos[1] + o2[1]});
         });
 
-    std::vector<double> t_pos = {p[e.t][0] + offset[0], p[e.t][1] + offset[1]};
+    t_pos = {t_pos[0] + offset[0], t_pos[1] + offset[1]};
 
     for (auto& o : offsets) {
       ipe.line(s_pos[0] + o[0], s_pos[1] + o[1], t_pos[0] + o[0],
                t_pos[1] + o[1]);
     }
-    // ipe.line(p[e.s][0], p[e.s][1], p[e.t][0], p[e.t][1]);
   }
   ipe.end_group();
 
   ipe.start_group();
-  for (unsigned i = 0; i < p.size(); ++i) {
-    ipe.disk(p[i][0], p[i][1], 1.5 * std::sqrt(w[i]));
+  for (unsigned i = 0; i < p.n; ++i) {
+    ipe.disk(p.coord(i, 0), p.coord(i, 1), 1.5 * std::sqrt(w[i]));
   }
   ipe.end_group();
   ipe.box(0, 0, 1, 1);
@@ -65,16 +67,6 @@ inline void print_graph(const std::vector<Edge>& E,
   ipe.label("$\\sigma = " + std::to_string(sigma) + "$", 0.5, 1.05);
 }
 
-inline double distance(const std::vector<double>& a,
-                       const std::vector<double>& b) {
-  auto result = 0.0;
-  for (auto d = 0u; d < a.size(); ++d) {
-    auto dist = std::abs(a[d] - b[d]);
-    dist = std::min(dist, 1.0 - dist);
-    result = std::max(result, dist);
-  }
-  return result;
-}
 
 inline void scale_weights(std::vector<double>& weights, double factor) {
   for (auto& w : weights) {
@@ -82,12 +74,58 @@ inline void scale_weights(std::vector<double>& weights, double factor) {
   }
 }
 
-inline std::vector<Edge> agirg(unsigned n, double ple, double deg, unsigned dim,
-                               double T, double sigma,
-                               double weight_correction_factor = 1.0,
-                               std::string ipe_output = "") {
-  // alpha = inverse temperature
+// Positions for n vertices in [0, 1]^dim.  The positions generated by
+// the girgs library depend on the number of threads -> generate them
+// sequentially to get reproducible graphs.
+inline std::vector<std::vector<double>> agirg_positions(unsigned n,
+                                                        unsigned dim,
+                                                        unsigned seed) {
+  int nr_threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  auto positions = girgs::generatePositions(n, dim, seed);
+  omp_set_num_threads(nr_threads);
+  return positions;
+}
+
+// Decreasingly sorted power-law weights of an AGIRG, scaled according
+// to the degree estimation of the GIRG generator.
+inline std::vector<double> agirg_base_weights(unsigned n, double ple,
+                                              double deg, unsigned dim,
+                                              double T) {
   double alpha = T > 0 ? 1 / T : std::numeric_limits<double>::infinity();
+  auto weights = power_law_weights(n, ple);
+  std::sort(weights.begin(), weights.end(), std::greater<double>());
+  girgs::scaleWeights(weights, deg, dim, alpha);
+  return weights;
+}
+
+// The seed-independent part of agirg_coupled(): the weights of the
+// AGIRGs (for each σ) and of the GIRG supergraph dominating them.
+struct CoupledAgirgWeights {
+  unsigned n;
+  unsigned dim;
+  double T;
+  std::vector<double> sigmas;
+  // decreasingly sorted weights before the σ-dependent scaling (only
+  // used for the visualization)
+  std::vector<double> initial_weights;
+  // for each σ: the AGIRG weights to the power of σ (for the lighter
+  // endpoint) and to the power of min(1, τ - σ) (for the heavier
+  // endpoint) and the sum of the AGIRG weights
+  std::vector<std::vector<double>> weights_sigma;
+  std::vector<std::vector<double>> weights_heavy;
+  std::vector<double> W_agirg;
+  std::vector<double> weights_girg;
+};
+
+// Computes the weights for agirg_coupled().  The weights of the i-th
+// AGIRG are additionally scaled by weight_correction_factors[i].
+inline CoupledAgirgWeights agirg_coupled_weights(
+    unsigned n, double ple, double deg, unsigned dim, double T,
+    const std::vector<double>& sigmas,
+    std::vector<double> weight_correction_factors = {}) {
+  unsigned k = sigmas.size();
+  weight_correction_factors.resize(k, 1.0);
 
   // We want to use the GIRG generator as black box to generate
   // AGIRGs.  For this, we have to choose GIRG weights such that the
@@ -99,8 +137,9 @@ inline std::vector<Edge> agirg(unsigned n, double ple, double deg, unsigned dim,
   // Note: Important that we pass a copy of the wights here, as we
   // potentially scale them but we do not want to actually scale the
   // AGIRG weights.
-  auto girg_supergraph_weights = [&n, &sigma](std::vector<double> weights_agirg,
-                                              double W_agirg) {
+  auto girg_supergraph_weights = [&n](double sigma,
+                                      std::vector<double> weights_agirg,
+                                      double W_agirg) {
     // nothing to do for sigma = 1
     if (sigma == 1) return weights_agirg;
 
@@ -129,95 +168,276 @@ inline std::vector<Edge> agirg(unsigned n, double ple, double deg, unsigned dim,
     }
 
     // additionally scale by W'' / W
-    double W_aux =
-        std::accumulate(weights_girg.begin(), weights_girg.end(), 0.0);
+    double W_aux = sum(weights_girg);
     scale_weights(weights_girg, W_aux / W_agirg);
 
     return weights_girg;
   };
 
-  // Start with decreasingly sorted power-law weights for the AGIRG.
-  auto weights_agirg = power_law_weights(n, ple);
-  std::sort(weights_agirg.begin(), weights_agirg.end(), std::greater<double>());
+  // Start with decreasingly sorted power-law weights for the AGIRG,
+  // scaled according to the girg degree estimation.
+  std::vector<double> initial_weights =
+      agirg_base_weights(n, ple, deg, dim, T);
+  double min_weight = initial_weights[n - 1];
+
+  // for each σ: weights of the AGIRG to the power of σ (for the
+  // lighter endpoint) and to the power of min(1, τ - σ) (for the
+  // heavier endpoint)
+  std::vector<std::vector<double>> weights_sigma(k), weights_heavy(k);
+  std::vector<double> W_agirg(k);
+
+  // weights of the GIRG supergraph: if y^σ are feasible weights for a
+  // single σ, then z_v = max_σ y^σ_v / sqrt(Y^σ) satisfies z_u z_v >=
+  // y^σ_u y^σ_v / Y^σ for all σ and the weights x_v = z_v * Z have
+  // weight part x_u x_v / X = z_u z_v
+  std::vector<double> weights_girg;
+  for (unsigned i = 0; i < k; ++i) {
+    // scale weights by a factor anticipating some weight change
+    // depending on sigma and by the correction factor
+    std::vector<double> weights_agirg = initial_weights;
+    double heuristic_factor = std::pow(min_weight, 1 - sigmas[i]);
+    scale_weights(weights_agirg,
+                  heuristic_factor * weight_correction_factors[i]);
+    W_agirg[i] = sum(weights_agirg);
+
+    auto weights_girg_sigma =
+        girg_supergraph_weights(sigmas[i], weights_agirg, W_agirg[i]);
+    if (k == 1) {
+      weights_girg = std::move(weights_girg_sigma);
+    } else {
+      double norm = std::sqrt(sum(weights_girg_sigma));
+      weights_girg.resize(n, 0.0);
+      for (Node v = 0; v < n; ++v) {
+        weights_girg[v] =
+            std::max(weights_girg[v], weights_girg_sigma[v] / norm);
+      }
+    }
 
-  // scale weights according to girg degree estimation
-  girgs::scaleWeights(weights_agirg, deg, dim, alpha);
-  std::vector<double> initial_weights = weights_agirg;
+    SigmaWeights powers(weights_agirg, ple, sigmas[i]);
+    weights_sigma[i] = std::move(powers.light);
+    weights_heavy[i] = std::move(powers.heavy);
+  }
+  if (k > 1) {
+    scale_weights(weights_girg, sum(weights_girg));
+  }
 
-  // scale weights by a factor anticipating some weight change
-  // depending on sigma and by the correction factor
-  double min_weight = weights_agirg[n - 1];
-  double heuristic_factor = std::pow(min_weight, 1 - sigma);
-  // double heuristic_factor = 1.0;
-  scale_weights(weights_agirg, heuristic_factor * weight_correction_factor);
+  return {n,
+          dim,
+          T,
+          sigmas,
+          std::move(initial_weights),
+          std::move(weights_sigma),
+          std::move(weights_heavy),
+          std::move(W_agirg),
+          std::move(weights_girg)};
+}
 
-  double W_agirg =
-      std::accumulate(weights_agirg.begin(), weights_agirg.end(), 0.0);
+// Generates one AGIRG for each σ in sigmas from a single GIRG
+// supergraph, i.e., the positions and the supergraph are only
+// generated once.  The supergraph weights are chosen such that the
+// GIRG dominates the AGIRGs of all σ.  Each supergraph edge uses the
+// same random number for the coin flips of all σ, i.e., the resulting
+// graphs are coupled.  This only uses the (thread local) random
+// generator, i.e., replicas for different seeds can be generated in
+// parallel from the same weights.
+inline std::vector<std::vector<Edge>> agirg_coupled(
+    const CoupledAgirgWeights& weights,
+    std::vector<std::string> ipe_outputs = {}) {
+  const auto& [n, dim, T, sigmas, initial_weights, weights_sigma,
+               weights_heavy, W_agirg, weights_girg] = weights;
+  // alpha = inverse temperature
+  double alpha = T > 0 ? 1 / T : std::numeric_limits<double>::infinity();
+  unsigned k = sigmas.size();
+  ipe_outputs.resize(k, "");
 
   // generate the GIRG supergraph
-  auto weights_girg = girg_supergraph_weights(weights_agirg, W_agirg);
   unsigned pseed = Random::natural_number();
   unsigned sseed = Random::natural_number();
-  auto positions = girgs::generatePositions(n, dim, pseed);
-  auto edges_girg = girgs::generateEdges(weights_girg, positions, alpha, sseed);
-
-  // filter GIRG edges to get the AGIRG
-  std::vector<Edge> edges_agirg;
-  double W_girg =
-      std::accumulate(weights_girg.begin(), weights_girg.end(), 0.0);
-  for (auto e : edges_girg) {
-    Node u = std::min(e.first, e.second);
-    Node v = std::max(e.first, e.second);
-
-    // weight part of the GIRG probability
-    double w_part_girg = weights_girg[u] * weights_girg[v] / W_girg;
-
-    // weight part of the AGIRG probability; note that u < v and thus w_u > w_v
-    double w_part_agirg =
-        std::pow(weights_agirg[v], sigma) *
-        std::pow(weights_agirg[u], std::min(1.0, ple - sigma)) / W_agirg;
-
-    if (w_part_girg < 1 && w_part_girg < w_part_agirg - 0.00001) {
-      std::cout << "GIRG probability too small" << std::endl;
-      std::cout << "w_girg[u] = " << weights_girg[u]
-                << ", w_girg[v] = " << weights_girg[v]
-                << ", W_girg = " << W_girg << std::endl;
-      std::cout << "w_agirg[u] = " << weights_agirg[u]
-                << ", w_agirg[v] = " << weights_agirg[v]
-                << ", W_agirg = " << W_agirg << std::endl;
-      std::cout << "w_part_girg: " << w_part_girg << std::endl;
-      std::cout << "w_part_agirg: " << w_part_agirg << std::endl;
-    }
-    assert(w_part_girg >= 1 || w_part_girg >= w_part_agirg - 0.00001);
-
-    // we also need the distance part of the probability (due to
-    // probabilities being capped at 1)
-    double dist = distance(positions[u], positions[v]);
-    double dist_part = std::pow(dist, dim);
-
-    // special handling for the temperature 0 case
-    if (T == 0) {
-      if (dist_part < w_part_agirg) {
-        edges_agirg.push_back({u, v});
+  auto girgs_positions = agirg_positions(n, dim, pseed);
+
+  // For T = 0, the GIRG is determined by the positions and weights and
+  // can thus be sampled in parallel (only the order of the edges
+  // depends on the number of threads).  For T > 0, the girgs library
+  // uses one random generator per thread, i.e., the sampled edges
+  // depend on the number of threads -> sample sequentially.
+  int nr_threads = omp_get_max_threads();
+  if (T != 0) omp_set_num_threads(1);
+  auto edges_girg =
+      girgs::generateEdges(weights_girg, girgs_positions, alpha, sseed);
+  omp_set_num_threads(nr_threads);
+  Positions positions(girgs_positions);
+  girgs_positions = {};
+
+  // filter GIRG edges to get the AGIRGs (in parallel); the coin flip
+  // for an edge is determined by its endpoints -> the result does not
+  // depend on the order of the edges or the number of threads
+  double W_girg = sum(weights_girg);
+  // (no random decisions for T = 0)
+  std::uint64_t filter_seed = T > 0 ? Random::natural_number() : 0;
+  const std::size_t chunk_size = 1 << 16;
+  std::size_t nr_chunks = (edges_girg.size() + chunk_size - 1) / chunk_size;
+  std::vector<std::vector<std::vector<Edge>>> edges_by_chunk(
+      k, std::vector<std::vector<Edge>>(nr_chunks));
+
+#pragma omp parallel for schedule(dynamic)
+  for (std::size_t chunk = 0; chunk < nr_chunks; ++chunk) {
+    std::size_t end = std::min(edges_girg.size(), (chunk + 1) * chunk_size);
+    for (std::size_t j = chunk * chunk_size; j < end; ++j) {
+      Node u = std::min(edges_girg[j].first, edges_girg[j].second);
+      Node v = std::max(edges_girg[j].first, edges_girg[j].second);
+
+      // weight part of the GIRG probability
+      double w_part_girg = weights_girg[u] * weights_girg[v] / W_girg;
+
+      // we also need the distance part of the probability (due to
+      // probabilities being capped at 1)
+      double dist = distance(positions, u, v);
+      double dist_part = std::pow(dist, dim);
+
+      double p_girg =
+          T == 0 ? 1.0
+                 : std::min(1.0, std::pow(w_part_girg / dist_part, alpha));
+      std::uint64_t key = (std::uint64_t(u) << 32) | v;
+      double coin = T == 0 ? 0.0 : hashed_uniform(filter_seed, key);
+
+      for (unsigned i = 0; i < k; ++i) {
+        // weight part of the AGIRG probability; note that u < v and
+        // thus w_u > w_v
+        double w_part_agirg =
+            weights_sigma[i][v] * weights_heavy[i][u] / W_agirg[i];
+
+        assert(w_part_girg >= 1 || w_part_girg >= w_part_agirg - 0.00001);
+
+        // special handling for the temperature 0 case
+        if (T == 0) {
+          if (dist_part < w_part_agirg) {
+            edges_by_chunk[i][chunk].push_back({u, v});
+          }
+          continue;
+        }
+
+        // correcting the connection probability
+        double p_agirg =
+            std::min(1.0, std::pow(w_part_agirg / dist_part, alpha));
+        if (coin < p_agirg / p_girg) {
+          edges_by_chunk[i][chunk].push_back({u, v});
+        }
       }
-      continue;
     }
+  }
 
-    // correcting the connection probability
-    double p_girg = std::min(1.0, std::pow(w_part_girg / dist_part, alpha));
-    double p_agirg = std::min(1.0, std::pow(w_part_agirg / dist_part, alpha));
-    if (Random::coin_flip(p_agirg / p_girg)) {
-      edges_agirg.push_back({u, v});
+  std::vector<std::vector<Edge>> result(k);
+  for (unsigned i = 0; i < k; ++i) {
+    for (auto& chunk_edges : edges_by_chunk[i]) {
+      result[i].insert(result[i].end(), chunk_edges.begin(),
+                       chunk_edges.end());
+      chunk_edges = {};
     }
+
+    // canonical order of the edges
+    sort_edges(result[i]);
+
+    if (ipe_outputs[i] != "")
+      print_graph(result[i], positions, initial_weights, ipe_outputs[i],
+                  sigmas[i]);
   }
 
-  // std::cout << "edges in the GIRG: " << edges_girg.size() << std::endl;
-  // std::cout << "edges in the AGIRG: " << edges_agirg.size() << std::endl;
+  return result;
+}
+
+// Generates coupled AGIRGs (see above) for the given parameters.
+// With a single σ, this is the same as agirg().
+inline std::vector<std::vector<Edge>> agirg_coupled(
+    unsigned n, double ple, double deg, unsigned dim, double T,
+    const std::vector<double>& sigmas,
+    std::vector<double> weight_correction_factors = {},
+    std::vector<std::string> ipe_outputs = {}) {
+  auto weights = agirg_coupled_weights(n, ple, deg, dim, T, sigmas,
+                                       std::move(weight_correction_factors));
+  return agirg_coupled(weights, std::move(ipe_outputs));
+}
+
+inline std::vector<Edge> agirg(unsigned n, double ple, double deg, unsigned dim,
+                               double T, double sigma,
+                               double weight_correction_factor = 1.0,
+                               std::string ipe_output = "") {
+  return std::move(agirg_coupled(n, ple, deg, dim, T, {sigma},
+                                 {weight_correction_factor}, {ipe_output})[0]);
+}
+
+// Same as agirg() but the edges are sampled directly with
+// agirg_edges() instead of filtering a GIRG supergraph, which avoids
+// sampling many unnecessary edges for σ far from 1.  For the same
+// seed, the positions are the same as for agirg() and thus for T = 0
+// also the graph.
+inline std::vector<Edge> agirg_native(unsigned n, double ple, double deg,
+                                      unsigned dim, double T, double sigma,
+                                      double weight_correction_factor = 1.0) {
+  auto weights = agirg_base_weights(n, ple, deg, dim, T);
+  double heuristic_factor = std::pow(weights[n - 1], 1 - sigma);
+  scale_weights(weights, heuristic_factor * weight_correction_factor);
+
+  unsigned pseed = Random::natural_number();
+  unsigned sseed = Random::natural_number();
+  Positions positions(agirg_positions(n, dim, pseed));
+  return agirg_edges(weights, positions, ple, sigma, T, sseed);
+}
+
+// Weight correction factor for agirg() such that the expected average
+// degree is deg.  Instead of generating graphs to measure the average
+// degree, the expected number of edges is estimated from the weights
+// (see AgirgEdgeEstimator) and the factor is found by root finding.
+inline double agirg_correction_factor(unsigned n, double ple, double deg,
+                                      unsigned dim, double T, double sigma) {
+  // the same weights agirg() starts with
+  auto weights = agirg_base_weights(n, ple, deg, dim, T);
+  double heuristic_factor = std::pow(weights[n - 1], 1 - sigma);
+
+  // scaling all weights by c scales the weight part of each connection
+  // probability by c^{σ + min(1, τ - σ) - 1}
+  double exponent = sigma + std::min(1.0, ple - sigma) - 1;
+  if (exponent <= 0) return 1.0;
+
+  AgirgEdgeEstimator expected_edges(weights, ple, sigma, dim, T);
+  double factor = find_root(expected_edges, 0.5 * n * deg,
+                            std::pow(heuristic_factor, exponent));
+  return std::pow(factor, 1 / exponent) / heuristic_factor;
+}
+
+// Weights for agirg_coupled() such that the average degrees of the
+// AGIRGs are close to deg (see agirg_calibrated_coupled()).
+inline CoupledAgirgWeights agirg_calibrated_weights(
+    unsigned n, double ple, double deg, unsigned dim, double T,
+    const std::vector<double>& sigmas) {
+  std::vector<double> correction_factors;
+  for (double sigma : sigmas) {
+    correction_factors.push_back(
+        sigma == 1.0 ? 1.0
+                     : agirg_correction_factor(n, ple, deg, dim, T, sigma));
+  }
+  return agirg_coupled_weights(n, ple, deg, dim, T, sigmas,
+                               std::move(correction_factors));
+}
 
-  if (ipe_output != "")
-    print_graph(edges_agirg, positions, initial_weights, ipe_output, sigma);
+// Generates AGIRGs (one for each σ in sigmas) whose average degrees
+// are close to deg.  For σ = 1, the weight scaling of the GIRG
+// generator already yields the correct average degree.  Otherwise,
+// the weights are corrected using agirg_correction_factor().  The
+// graphs are coupled, see agirg_coupled().
+inline std::vector<std::vector<Edge>> agirg_calibrated_coupled(
+    unsigned n, double ple, double deg, unsigned dim, double T,
+    const std::vector<double>& sigmas,
+    std::vector<std::string> ipe_outputs = {}) {
+  return agirg_coupled(agirg_calibrated_weights(n, ple, deg, dim, T, sigmas),
+                       std::move(ipe_outputs));
+}
 
-  return edges_agirg;
+// Generates an AGIRG whose average degree is close to deg.
+inline std::vector<Edge> agirg_calibrated(unsigned n, double ple, double deg,
+                                          unsigned dim, double T, double sigma,
+                                          std::string ipe_output = "") {
+  return std::move(
+      agirg_calibrated_coupled(n, ple, deg, dim, T, {sigma}, {ipe_output})[0]);
 }
 
 TEST_CASE("[GIRG] agirg correct graph") {
@@ -232,7 +452,7 @@ TEST_CASE("[GIRG] agirg correct graph") {
     // positions with the same seed
     Random::set_seed(1234);
     unsigned pseed = Random::natural_number();
-    auto positions = girgs::generatePositions(n, dim, pseed);
+    Positions positions(agirg_positions(n, dim, pseed));
 
     // weights
     auto weights = power_law_weights(n, ple);
@@ -260,7 +480,7 @@ TEST_CASE("[GIRG] agirg correct graph") {
         double w_u_part = std::pow(weights[u], std::min(1.0, ple - sigma));
         double w_v_part = std::pow(weights[v], sigma);
         double weights_part = w_u_part * w_v_part / W;
-        double dist_part = std::pow(distance(positions[u], positions[v]), dim);
+        double dist_part = std::pow(distance(positions, u, v), dim);
 
         bool connected = weights_part >= dist_part;
         std::string err_msg =
@@ -285,3 +505,95 @@ TEST_CASE("[GIRG] agirg correct graph") {
     }
   }
 }
+
+TEST_CASE("[GIRG] agirg independent of the number of threads") {
+  int nr_threads = omp_get_max_threads();
+  for (double T : {0.0, 0.5}) {
+    std::vector<std::vector<Edge>> graphs;
+    for (int threads : {1, 3}) {
+      omp_set_num_threads(threads);
+      Random::set_seed(42);
+      graphs.push_back(agirg(200, 2.5, 10, 2, T, 0.6));
+    }
+    REQUIRE(graphs[0].size() == graphs[1].size());
+    for (unsigned i = 0; i < graphs[0].size(); ++i) {
+      CHECK(graphs[0][i].s == graphs[1][i].s);
+      CHECK(graphs[0][i].t == graphs[1][i].t);
+    }
+  }
+  omp_set_num_threads(nr_threads);
+}
+
+TEST_CASE("[GIRG] agirg calibrated average degree") {
+  unsigned n = 3000;
+  double deg = 10;
+  for (double sigma : {0.5, 1.5}) {
+    for (double T : {0.0, 0.5}) {
+      Random::set_seed(7);
+      auto edges = agirg_calibrated(n, 2.5, deg, 1, T, sigma);
+      CHECK(2.0 * edges.size() / n == doctest::Approx(deg).epsilon(0.1));
+    }
+  }
+}
+
+TEST_CASE("[GIRG] coupled agirgs") {
+  std::vector<double> sigmas = {0.4, 1.0, 1.6};
+  for (double T : {0.0, 0.5}) {
+    Random::set_seed(5);
+    auto coupled = agirg_coupled(300, 2.5, 10, 2, T, sigmas);
+    REQUIRE(coupled.size() == sigmas.size());
+    for (unsigned i = 0; i < sigmas.size(); ++i) {
+      Random::set_seed(5);
+      auto single = agirg(300, 2.5, 10, 2, T, sigmas[i]);
+      if (T == 0) {
+        // for T = 0, the graph is determined by the positions, which
+        // are the same for the same seed
+        REQUIRE(coupled[i].size() == single.size());
+        for (unsigned j = 0; j < single.size(); ++j) {
+          CHECK(coupled[i][j].s == single[j].s);
+          CHECK(coupled[i][j].t == single[j].t);
+        }
+      } else {
+        // otherwise, the graphs only have the same distribution
+        CHECK(double(coupled[i].size()) ==
+              doctest::Approx(single.size()).epsilon(0.15));
+      }
+    }
+  }
+}
+
+TEST_CASE("[GIRG] agirg replicas") {
+  // replicas generated in parallel from the same weights are the same
+  // as generating each graph on its own
+  std::vector<unsigned> seeds = {3, 4, 9};
+  for (double T : {0.0, 0.5}) {
+    auto weights = agirg_calibrated_weights(500, 2.5, 10, 2, T, {0.6});
+    std::vector<std::vector<Edge>> replicas(seeds.size());
+    for_each_seed(seeds, [&](std::size_t i) {
+      replicas[i] = std::move(agirg_coupled(weights)[0]);
+    });
+    for (std::size_t i = 0; i < seeds.size(); ++i) {
+      Random::set_seed(seeds[i]);
+      auto edges = agirg_calibrated(500, 2.5, 10, 2, T, 0.6);
+      REQUIRE(edges.size() == replicas[i].size());
+      for (std::size_t j = 0; j < edges.size(); ++j) {
+        CHECK(edges[j].s == replicas[i][j].s);
+        CHECK(edges[j].t == replicas[i][j].t);
+      }
+    }
+  }
+}
+
+TEST_CASE("[GIRG] native agirg sampler") {
+  for (double sigma : {0.2, 1.0, 1.8}) {
+    Random::set_seed(11);
+    auto supergraph = agirg(500, 2.5, 10, 2, 0, sigma);
+    Random::set_seed(11);
+    auto native = agirg_native(500, 2.5, 10, 2, 0, sigma);
+    REQUIRE(supergraph.size() == native.size());
+    for (unsigned i = 0; i < native.size(); ++i) {
+      CHECK(supergraph[i].s == native[i].s);
+      CHECK(supergraph[i].t == native[i].t);
+    }
+  }
+}
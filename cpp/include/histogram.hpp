@@ -1,9 +1,14 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <map>
 #include <ostream>
+#include <utility>
 #include <vector>
 
 #include "doctest.h"
+#include "random.hpp"
 #include "types.hpp"
 
 // a histogram of natural number measurement
@@ -11,6 +16,12 @@ class Histogram {
  public:
   Histogram();
 
+  // Histogram of all the measurements at once: the maximum is
+  // determined first (such that the frequencies are allocated only
+  // once), then each thread counts its share of the measurements in a
+  // local histogram; these are added up in parallel.
+  Histogram(const std::vector<unsigned>& measurements);
+
   // add a measurement to the histogram
   void add(unsigned measurement);
 
@@ -18,11 +29,11 @@ class Histogram {
   unsigned maximum() const;
 
   // number of observations of given measurement
-  unsigned frequency(unsigned measurement) const;
+  std::uint64_t frequency(unsigned measurement) const;
 
  private:
   unsigned m_max;
-  std::vector<unsigned> m_frequency_by_measurement;
+  std::vector<std::uint64_t> m_frequency_by_measurement;
 };
 
 // create a sequence of breaks between buckets starting with min and
@@ -30,14 +41,37 @@ class Histogram {
 // constant factor apart
 std::vector<double> log_breaks(double min, double max, unsigned nr_buckets);
 
+// a point together with its number of occurrences
+struct PointCount {
+  Point point;
+  std::uint64_t count;
+};
+
+// The distinct points with their multiplicities, sorted by x and then
+// by y.  For degree points, this is the exact (sparse) joint degree
+// table, from which histograms with different numbers of buckets can
+// be computed in time linear in the number of distinct points.  The
+// points are counted in parallel: in one dense table of counters per
+// thread if these need at most max_dense_counters counters in total,
+// and otherwise by partitioning the points by their x-values and
+// sorting each partition.
+std::vector<PointCount> count_points(
+    const std::vector<Point>& points,
+    std::size_t max_dense_counters = std::size_t(1) << 26);
+
 // 2D histogram aggregating 2D data into buckets
 class Histogram2D {
  public:
   Histogram2D(const std::vector<Point>& points, unsigned nr_buckets,
               bool complementary_cumulative = false);
 
-  unsigned count(unsigned bucket_x, unsigned bucket_y) const {
-    return m_histogram[bucket_x][bucket_y];
+  // the same histogram from the distinct points and their
+  // multiplicities (see count_points())
+  Histogram2D(const std::vector<PointCount>& point_counts,
+              unsigned nr_buckets, bool complementary_cumulative = false);
+
+  std::uint64_t count(unsigned bucket_x, unsigned bucket_y) const {
+    return m_histogram[bucket_x * m_nr_buckets + bucket_y];
   };
 
   // lower bound, upper bound and center (logarithmic) of a bucket
@@ -50,13 +84,45 @@ class Histogram2D {
   double center_y(unsigned bucket) const { return m_bucket_center_y[bucket]; }
 
  private:
-  std::vector<std::vector<unsigned>> m_histogram;
+  // Fills the histogram with the nr_points points point(i), each
+  // counted weight(i) times (1 for individual points, the multiplicity
+  // for counted points).
+  template <typename PointOf, typename WeightOf>
+  void fill(std::size_t nr_points, PointOf point, WeightOf weight,
+            unsigned nr_buckets);
+
+  // breaks and bucket centers for the given maxima; empty histogram
+  void init_buckets(unsigned max_x, unsigned max_y, unsigned nr_buckets);
+
+  void make_complementary_cumulative();
+
+  unsigned m_nr_buckets;
+  // the counts in row-major order (row x, column y)
+  std::vector<std::uint64_t> m_histogram;
   std::vector<double> m_breaks_x;
   std::vector<double> m_breaks_y;
   std::vector<double> m_bucket_center_x;
   std::vector<double> m_bucket_center_y;
 };
 
+TEST_CASE("[Histogram] bulk construction") {
+  std::vector<unsigned> measurements;
+  Histogram H_incremental;
+  for (unsigned i = 0; i < 100000; ++i) {
+    unsigned m = (i * 7919) % 1000 < 900 ? i % 10 : i % 5000;
+    measurements.push_back(m);
+    H_incremental.add(m);
+  }
+  Histogram H(measurements);
+  CHECK(H.maximum() == H_incremental.maximum());
+  for (unsigned m = 0; m <= H.maximum() + 1; ++m) {
+    REQUIRE(H.frequency(m) == H_incremental.frequency(m));
+  }
+  Histogram H_empty(std::vector<unsigned>{});
+  CHECK(H_empty.maximum() == 0);
+  CHECK(H_empty.frequency(0) == 0);
+}
+
 TEST_CASE("[log breaks]") {
   // 4 buckets: 1-2, 2-4, 4-8, 8-16
   auto breaks = log_breaks(1.0, 16.0, 4);
@@ -65,3 +131,84 @@ TEST_CASE("[log breaks]") {
   CHECK(breaks[0] == 1.0);
   CHECK(breaks[4] == 16.0);
 }
+
+TEST_CASE("[Histogram2D] bucketing") {
+  // points on and between the breaks 1, 2, 4, 8, 16
+  std::vector<Point> points;
+  for (unsigned x = 1; x <= 15; ++x) {
+    for (unsigned y = 1; y <= x; ++y) points.push_back({x, y});
+  }
+  points.push_back({15, 15});
+  Histogram2D H(points, 4);
+  auto bucket = [](unsigned val) -> unsigned {
+    return val < 2 ? 0 : val < 4 ? 1 : val < 8 ? 2 : 3;
+  };
+  for (unsigned x = 0; x < 4; ++x) {
+    for (unsigned y = 0; y < 4; ++y) {
+      unsigned expected = 0;
+      for (const Point& p : points) {
+        expected += bucket(p.x) == x && bucket(p.y) == y;
+      }
+      CHECK(H.count(x, y) == expected);
+    }
+  }
+
+  Histogram2D H_cumulative(points, 4, true);
+  CHECK(H_cumulative.count(0, 0) == points.size());
+  for (unsigned x = 0; x < 4; ++x) {
+    for (unsigned y = 0; y < 4; ++y) {
+      std::uint64_t expected = 0;
+      for (unsigned x2 = x; x2 < 4; ++x2) {
+        for (unsigned y2 = y; y2 < 4; ++y2) expected += H.count(x2, y2);
+      }
+      CHECK(H_cumulative.count(x, y) == expected);
+    }
+  }
+
+  // the same from the counted points (for different resolutions)
+  auto counts = count_points(points);
+  CHECK(counts.size() == points.size() - 1);
+  CHECK(counts.back().point.x == 15);
+  CHECK(counts.back().point.y == 15);
+  CHECK(counts.back().count == 2);
+  for (unsigned nr_buckets : {1, 3, 4, 7}) {
+    for (bool cumulative : {false, true}) {
+      Histogram2D H_points(points, nr_buckets, cumulative);
+      Histogram2D H_counts(counts, nr_buckets, cumulative);
+      for (unsigned x = 0; x < nr_buckets; ++x) {
+        for (unsigned y = 0; y < nr_buckets; ++y) {
+          CHECK(H_points.count(x, y) == H_counts.count(x, y));
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("[Histogram2D] counting points") {
+  Random::set_seed(7);
+  std::vector<Point> points;
+  std::map<std::pair<unsigned, unsigned>, std::uint64_t> expected;
+  for (unsigned i = 0; i < 20000; ++i) {
+    // many duplicates for small values
+    unsigned x = 1 + Random::natural_number(5) * Random::natural_number(40);
+    unsigned y = 1 + Random::natural_number(i % 7 == 0 ? 3000 : 9);
+    points.push_back({x, y});
+    expected[{x, y}]++;
+  }
+
+  // dense counters, partitioned points
+  for (std::size_t max_dense_counters :
+       {std::size_t(1) << 26, std::size_t(0)}) {
+    auto counts = count_points(points, max_dense_counters);
+    REQUIRE(counts.size() == expected.size());
+    auto it = expected.begin();
+    for (const PointCount& c : counts) {
+      CHECK(c.point.x == it->first.first);
+      CHECK(c.point.y == it->first.second);
+      CHECK(c.count == it->second);
+      ++it;
+    }
+  }
+  CHECK(count_points({}).empty());
+  CHECK(count_points({}, 0).empty());
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "doctest.h"
+#include "random.hpp"
+#include "types.hpp"
+
+// Polar coordinates of the vertices of a hyperbolic random graph.
+struct HyperbolicPoints {
+  std::vector<double> radius;
+  std::vector<double> angle;
+};
+
+// n points in a hyperbolic disk of radius R: the angles are uniform
+// in [0, 2π) and the radii have density α sinh(α r) / (cosh(α R) - 1)
+// with α = (ple - 1) / 2.  The result only depends on the seed.
+HyperbolicPoints hrg_points(unsigned n, double R, double ple,
+                            std::uint64_t seed);
+
+// Connection probability of two vertices at hyperbolic distance d:
+// 1 / (1 + exp((d - R) / (2T))), i.e., for T = 0 the vertices are
+// connected if and only if d <= R.
+inline double hrg_probability(double d, double R, double T) {
+  if (T == 0) return d <= R ? 1.0 : 0.0;
+  return 1 / (1 + std::exp((d - R) / (2 * T)));
+}
+
+// hyperbolic distance of two points given in polar coordinates
+inline double hyperbolic_distance(double r1, double phi1, double r2,
+                                  double phi2) {
+  // cosh(d) = cosh(r1 - r2) + 2 sinh(r1) sinh(r2) sin²(Δφ / 2), which
+  // is numerically more stable than the usual form for close points
+  double sin_half = std::sin((phi1 - phi2) / 2);
+  return std::acosh(std::cosh(r1 - r2) + 2 * std::sinh(r1) * std::sinh(r2) *
+                                              sin_half * sin_half);
+}
+
+// Samples the edges of a hyperbolic random graph on the given points
+// in expected time O(n log n + m): each vertex visits each of the
+// Θ(log n) outer bands (with constant work per band besides the
+// candidates it checks).
+//
+// The disk is divided into radial bands (one band for radii below
+// R / 2 and bands of width 1 beyond that); the points of each band are
+// sorted by angle.  Each vertex only looks for neighbors in its own
+// and the outer bands, starting at its own angle and moving outwards
+// in both directions.  From a lower bound on the distance to points
+// in a band, one gets the angular range that can contain neighbors
+// (T = 0) or a decreasing upper bound on the connection probability
+// that is used to jump directly to the next candidate (T > 0).
+std::vector<Edge> hrg_edges(const HyperbolicPoints& points, double R,
+                            double T, std::uint64_t seed);
+
+// Expected average degree of a hyperbolic random graph (via numerical
+// integration).
+double hrg_expected_degree(unsigned n, double R, double ple, double T);
+
+// The radius R such that the expected average degree is deg.
+double hrg_radius(unsigned n, double deg, double ple, double T);
+
+// A generated hyperbolic random graph and the radius of its disk.
+struct HyperbolicGraph {
+  double R;
+  std::vector<Edge> edges;
+};
+
+// Generates a hyperbolic random graph with expected average degree deg
+// (using the seed of Random).
+HyperbolicGraph hrg(unsigned n, double deg, double ple, double T);
+
+TEST_CASE("[HRG] threshold graph") {
+  unsigned n = 1000;
+  double R = 2 * std::log(n);
+  for (double ple : {2.2, 2.8}) {
+    auto points = hrg_points(n, R, ple, 4);
+    auto edges = hrg_edges(points, R, 0, 5);
+    std::vector<Edge> expected;
+    for (Node u = 0; u < n; ++u) {
+      for (Node v = u + 1; v < n; ++v) {
+        if (hyperbolic_distance(points.radius[u], points.angle[u],
+                                points.radius[v], points.angle[v]) <= R) {
+          expected.push_back({u, v});
+        }
+      }
+    }
+    REQUIRE(edges.size() == expected.size());
+    for (unsigned i = 0; i < edges.size(); ++i) {
+      CHECK(edges[i].s == expected[i].s);
+      CHECK(edges[i].t == expected[i].t);
+    }
+  }
+}
+
+TEST_CASE("[HRG] temperature") {
+  unsigned n = 2000;
+  double R = 2 * std::log(n) - 1, T = 0.5;
+  auto points = hrg_points(n, R, 2.5, 4);
+  double expected = 0;
+  for (Node u = 0; u < n; ++u) {
+    for (Node v = u + 1; v < n; ++v) {
+      double d = hyperbolic_distance(points.radius[u], points.angle[u],
+                                     points.radius[v], points.angle[v]);
+      expected += hrg_probability(d, R, T);
+    }
+  }
+  double sampled = 0;
+  for (unsigned seed = 0; seed < 5; ++seed) {
+    sampled += hrg_edges(points, R, T, seed).size();
+  }
+  CHECK(sampled / 5 == doctest::Approx(expected).epsilon(0.03));
+}
+
+TEST_CASE("[HRG] average degree") {
+  unsigned n = 20000;
+  double deg = 10;
+  for (double T : {0.0, 0.5}) {
+    for (double ple : {2.2, 2.8}) {
+      double R = hrg_radius(n, deg, ple, T);
+      CHECK(hrg_expected_degree(n, R, ple, T) == doctest::Approx(deg));
+      // average over a few graphs
+      double avg_deg = 0;
+      for (unsigned seed = 0; seed < 4; ++seed) {
+        Random::set_seed(seed);
+        auto graph = hrg(n, deg, ple, T);
+        CHECK(graph.R == R);
+        avg_deg += 2.0 * graph.edges.size() / n / 4;
+      }
+      CHECK(avg_deg == doctest::Approx(deg).epsilon(0.1));
+    }
+  }
+}
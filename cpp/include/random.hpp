@@ -1,7 +1,13 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <limits>
 #include <random>
+#include <vector>
+
+#include "doctest.h"
 
 class Random {
  public:
@@ -21,10 +27,11 @@ class Random {
   unsigned m_seed;
   std::default_random_engine m_engine;
   
-  // Implementation of the singleton pattern.
+  // Implementation of the singleton pattern.  Each thread has its own
+  // instance, such that independent generators can run in parallel.
   Random();
   static Random& get_singleton() {
-    static Random instance;
+    static thread_local Random instance;
     return instance;
   }
 
@@ -32,3 +39,84 @@ class Random {
   Random(const Random&) = delete;
   void operator=(const Random&) = delete;
 };
+
+// Calls f(i) for each i = 0, ..., seeds.size() - 1, after setting the
+// seed of the calling thread to seeds[i], i.e., f(i) can generate the
+// i-th replica of a random graph.  The replicas are generated in
+// parallel; if there are fewer replicas than threads, the remaining
+// threads are split among them (nested parallelism).
+void for_each_seed(const std::vector<unsigned>& seeds,
+                   const std::function<void(std::size_t)>& f);
+
+// Mixing function of SplitMix64, scrambling the bits of a 64-bit
+// integer.
+inline std::uint64_t mix64(std::uint64_t z) {
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+// Seed of the index-th independent random stream derived from seed.
+inline std::uint64_t substream_seed(std::uint64_t seed, std::uint64_t index) {
+  return mix64(mix64(seed) + mix64(index + 0x9e3779b97f4a7c15));
+}
+
+// Uniform double in [0, 1) determined by a seed and a key (e.g., a
+// vertex pair).  Useful for random decisions that should not depend
+// on the order in which they are made.
+inline double hashed_uniform(std::uint64_t seed, std::uint64_t key) {
+  return (substream_seed(seed, key) >> 11) * 0x1.0p-53;
+}
+
+// Small and fast random generator (SplitMix64) for the many
+// independent streams used when generating in parallel.  It satisfies
+// the requirements of a uniform random bit generator and can thus be
+// used with the std distributions.
+class RandomStream {
+ public:
+  using result_type = std::uint64_t;
+
+  explicit RandomStream(std::uint64_t seed) : m_state(seed) {}
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()() { return mix64(m_state += 0x9e3779b97f4a7c15); }
+
+  // uniform double in [0, 1)
+  double uniform() { return ((*this)() >> 11) * 0x1.0p-53; }
+
+  bool coin_flip(double p) { return uniform() < p; }
+
+ private:
+  std::uint64_t m_state;
+};
+
+// Number of good elements when drawing sample elements without
+// replacement from good good and bad bad elements (hypergeometric
+// distribution).  For large samples, this uses the ratio of uniforms
+// method HRUA by Stadlober; otherwise the draws are simulated.
+std::uint64_t hypergeometric(std::uint64_t good, std::uint64_t bad,
+                             std::uint64_t sample, RandomStream& rng);
+
+TEST_CASE("[Random] hypergeometric") {
+  RandomStream rng(3);
+  for (std::uint64_t sample : {5, 1000, 99000}) {
+    std::uint64_t good = 30000, bad = 70000;
+    double sum = 0;
+    unsigned repetitions = 2000;
+    for (unsigned i = 0; i < repetitions; ++i) {
+      auto k = hypergeometric(good, bad, sample, rng);
+      REQUIRE(k <= std::min(good, sample));
+      REQUIRE(sample - k <= bad);
+      sum += k;
+    }
+    // the standard deviation of the mean is below 0.5
+    CHECK(sum / repetitions == doctest::Approx(0.3 * sample).epsilon(0.01));
+  }
+  CHECK(hypergeometric(10, 0, 7, rng) == 7);
+  CHECK(hypergeometric(0, 10, 7, rng) == 0);
+  CHECK(hypergeometric(40, 60, 100, rng) == 40);
+}
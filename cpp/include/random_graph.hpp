@@ -1,18 +1,307 @@
 #pragma once
 
+#include <omp.h>
+
+#include <algorithm>
+#include <functional>
+#include <sstream>
 #include <vector>
 
+#include "doctest.h"
+#include "edge_list.hpp"
+#include "random.hpp"
 #include "types.hpp"
+#include "weights.hpp"
 
 inline double avg_deg_to_p(unsigned n, double avg_deg) {
   return avg_deg / (n - 1);
 }
 
+// Random graph with n nodes where each pair of nodes is connected with
+// probability p.  The edges (u, v) with u > v are sorted
+// lexicographically.  They are sampled in parallel, but the result
+// only depends on the seed.
 std::vector<Edge> gilbert(unsigned n, double p);
 
+// Uniformly random graph with n nodes and m edges (m must be at most n
+// (n - 1) / 2).  The edges (u, v) with u > v are sorted
+// lexicographically.  They are sampled in parallel, but the result
+// only depends on the seed.
 std::vector<Edge> erdos_renyi(unsigned n, unsigned m);
 
+// Chung-Lu graph with power-law weights, where the factor adjusting
+// the connection probabilities is chosen such that the expected
+// average degree is avg_deg (up to a relative error of tolerance).
 std::vector<Edge> chung_lu(unsigned n, double ple, double avg_deg,
-                           double sigma = 1);
+                           double sigma = 1, double tolerance = 1e-6);
+
+// The seed-independent part of chung_lu(): the decreasingly sorted
+// weights, their powers and the calibrated factor adjusting the
+// connection probabilities.  Computing it once and passing it to
+// chung_lu() for each seed avoids repeating the calibration for
+// multiple replicas.
+struct ChungLuWeights {
+  ChungLuWeights(unsigned n, double ple, double avg_deg, double sigma = 1,
+                 double tolerance = 1e-6);
+
+  std::vector<double> weights;
+  SigmaWeights powers;
+  double weight_sum;
+  double deg_correction;
+};
+
+// Chung-Lu graph for precomputed weights, using the (thread local)
+// random generator, i.e., it can be called in parallel for different
+// seeds.
+std::vector<Edge> chung_lu(const ChungLuWeights& weights);
+
+// Parameters of a Chung-Lu graph that is too large to be kept in
+// memory (e.g., n = 10^9).  Instead of the weights and their powers
+// (as in ChungLuWeights), only the sums needed for the connection
+// probabilities are kept; the powers are recomputed from the closed
+// form of the weights.  The weights are only held temporarily for
+// the calibration.
+struct ChungLuOutOfCore {
+  ChungLuOutOfCore(unsigned n, double ple, double avg_deg, double sigma = 1,
+                   double tolerance = 1e-6);
+
+  unsigned n;
+  double ple;
+  double sigma;
+  double weight_sum;
+  // sum of w^σ over all vertices
+  double light_sum;
+  double deg_correction;
+};
+
+// Out-of-core variant of chung_lu(): the edges (u, v) with u < v are
+// generated in parallel in blocks of source vertices, whose expected
+// number of edges is bounded.  The edges are passed to emit in
+// batches of a few blocks (lexicographically sorted across all
+// batches), e.g., for writing them to a BinaryEdgeWriter, such that
+// the memory does not grow with the number of edges.  The result only
+// depends on the seed (not on the number of threads), but differs
+// from chung_lu() for the same seed.
+void chung_lu(const ChungLuOutOfCore& params,
+              const std::function<void(const std::vector<Edge>&)>& emit);
+
+// Directed Chung-Lu graph with power-law out- and in-weights (with
+// exponents ple_out and ple_in) and expected average degree avg_deg
+// (counting in- and out-edges, i.e., the expected number of edges is
+// n avg_deg / 2).  For correlation 1, the vertex with the i-th largest
+// out-weight has the i-th largest in-weight; for correlation 0, the
+// in-weights are assigned independently.  In between, each vertex
+// keeps its in-weight rank with probability correlation.  The edge
+// (u, v) exists with probability proportional to min(w_u, w_v)^σ
+// max(w_u, w_v)^min(1, τ - σ) (capped at 1), where w_u is the
+// out-weight of u, w_v is the in-weight of v, and τ is the exponent
+// of the larger weight.  There are no self-loops.  The edges are
+// sorted; the result only depends on the seed.
+std::vector<Edge> chung_lu_directed(unsigned n, double ple_out, double ple_in,
+                                    double avg_deg, double correlation = 1,
+                                    double sigma = 1);
+
+// Bipartite Chung-Lu graph with n1 and n2 vertices in the two
+// partitions and power-law weights with exponents ple1 and ple2.  The
+// connection probabilities are as for chung_lu_directed.  The
+// expected average degree (over all n1 + n2 vertices) is avg_deg.
+// Each edge (u, v) connects u of the first and v of the second
+// partition; both are numbered starting at 0.
+std::vector<Edge> chung_lu_bipartite(unsigned n1, unsigned n2, double ple1,
+                                     double ple2, double avg_deg,
+                                     double sigma = 1);
+
+TEST_CASE("[Random Graph] erdos renyi") {
+  auto check = [](unsigned n, unsigned m) {
+    Random::set_seed(8);
+    auto edges = erdos_renyi(n, m);
+    REQUIRE(edges.size() == m);
+    for (unsigned i = 0; i < m; ++i) {
+      REQUIRE(edges[i].s < n);
+      REQUIRE(edges[i].t < edges[i].s);
+      if (i > 0) {
+        // strictly increasing -> no duplicates
+        REQUIRE((edges[i - 1].s < edges[i].s ||
+                 (edges[i - 1].s == edges[i].s &&
+                  edges[i - 1].t < edges[i].t)));
+      }
+    }
+    return edges;
+  };
+
+  check(10, 0);
+  // complete graph
+  auto complete = check(300, 300 * 299 / 2);
+  CHECK(complete.back().s == 299);
+  CHECK(complete.back().t == 298);
+  check(100000, 1000000);
+
+  // same graph for different numbers of threads
+  int nr_threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  auto edges1 = check(5000, 200000);
+  omp_set_num_threads(3);
+  auto edges3 = check(5000, 200000);
+  omp_set_num_threads(nr_threads);
+  for (unsigned i = 0; i < edges1.size(); ++i) {
+    CHECK(edges1[i].s == edges3[i].s);
+    CHECK(edges1[i].t == edges3[i].t);
+  }
+
+  // each pair is sampled with probability m / nr_pairs
+  std::vector<unsigned> count(10 * 9 / 2, 0);
+  for (unsigned seed = 0; seed < 4000; ++seed) {
+    Random::set_seed(seed);
+    for (auto [u, v] : erdos_renyi(10, 9)) count[u * (u - 1) / 2 + v]++;
+  }
+  for (unsigned c : count) CHECK(c == doctest::Approx(800).epsilon(0.15));
+}
+
+TEST_CASE("[Random Graph] gilbert") {
+  // same graph for different numbers of threads
+  int nr_threads = omp_get_max_threads();
+  std::vector<std::vector<Edge>> graphs;
+  for (int threads : {1, 3}) {
+    omp_set_num_threads(threads);
+    Random::set_seed(4);
+    graphs.push_back(gilbert(20000, 0.001));
+  }
+  omp_set_num_threads(nr_threads);
+  REQUIRE(graphs[0].size() == graphs[1].size());
+  for (unsigned i = 0; i < graphs[0].size(); ++i) {
+    CHECK(graphs[0][i].s == graphs[1][i].s);
+    CHECK(graphs[0][i].t == graphs[1][i].t);
+  }
 
-std::vector<double> power_law_weights(unsigned n, double ple);
+  // sorted edges with roughly p n (n - 1) / 2 edges
+  auto& edges = graphs[0];
+  for (unsigned i = 1; i < edges.size(); ++i) {
+    REQUIRE(edges[i].t < edges[i].s);
+    REQUIRE((edges[i - 1].s < edges[i].s ||
+             (edges[i - 1].s == edges[i].s && edges[i - 1].t < edges[i].t)));
+  }
+  CHECK(edges.size() ==
+        doctest::Approx(0.001 * 20000 * 19999 / 2).epsilon(0.01));
+
+  Random::set_seed(4);
+  CHECK(gilbert(100, 1.0).size() == 100 * 99 / 2);
+  CHECK(gilbert(100, 0.0).empty());
+}
+
+TEST_CASE("[Random Graph] chung lu average degree") {
+  // including extreme combinations where many probabilities are capped
+  unsigned n = 100000;
+  for (double ple : {2.1, 2.9}) {
+    for (double sigma : {0.2, 1.0, 1.9}) {
+      Random::set_seed(11);
+      auto edges = chung_lu(n, ple, 10, sigma);
+      CHECK(2.0 * edges.size() / n == doctest::Approx(10).epsilon(0.02));
+    }
+  }
+}
+
+TEST_CASE("[Random Graph] chung lu replicas") {
+  // replicas generated in parallel from the same weights are the same
+  // as generating each graph on its own
+  std::vector<unsigned> seeds = {5, 8, 13};
+  ChungLuWeights weights(20000, 2.4, 10, 0.7);
+  std::vector<std::vector<Edge>> replicas(seeds.size());
+  for_each_seed(seeds, [&](std::size_t i) { replicas[i] = chung_lu(weights); });
+  for (std::size_t i = 0; i < seeds.size(); ++i) {
+    Random::set_seed(seeds[i]);
+    auto edges = chung_lu(20000, 2.4, 10, 0.7);
+    REQUIRE(edges.size() == replicas[i].size());
+    for (std::size_t j = 0; j < edges.size(); ++j) {
+      REQUIRE(edges[j].s == replicas[i][j].s);
+      REQUIRE(edges[j].t == replicas[i][j].t);
+    }
+  }
+}
+
+TEST_CASE("[Random Graph] chung lu out of core") {
+  unsigned n = 200000;
+  for (double sigma : {0.4, 1.0, 1.7}) {
+    ChungLuOutOfCore params(n, 2.3, 10, sigma);
+    auto generate = [&]() {
+      Random::set_seed(4);
+      std::vector<Edge> edges;
+      chung_lu(params, [&](const std::vector<Edge>& batch) {
+        edges.insert(edges.end(), batch.begin(), batch.end());
+      });
+      return edges;
+    };
+    auto edges = generate();
+    CHECK(2.0 * edges.size() / n == doctest::Approx(10).epsilon(0.02));
+    for (unsigned i = 0; i < edges.size(); ++i) {
+      REQUIRE(edges[i].s < edges[i].t);
+      REQUIRE(edges[i].t < n);
+      if (i > 0) {
+        // strictly increasing -> no duplicates
+        REQUIRE((edges[i - 1].s < edges[i].s ||
+                 (edges[i - 1].s == edges[i].s &&
+                  edges[i - 1].t < edges[i].t)));
+      }
+    }
+
+    // same graph for different numbers of threads (and thus batches)
+    int nr_threads = omp_get_max_threads();
+    omp_set_num_threads(nr_threads == 3 ? 2 : 3);
+    auto edges_other = generate();
+    omp_set_num_threads(nr_threads);
+    REQUIRE(edges.size() == edges_other.size());
+    for (unsigned i = 0; i < edges.size(); ++i) {
+      REQUIRE(edges[i].s == edges_other[i].s);
+      REQUIRE(edges[i].t == edges_other[i].t);
+    }
+  }
+}
+
+TEST_CASE("[Random Graph] directed chung lu") {
+  unsigned n = 50000;
+  // different exponents make the probabilities jump where the in- and
+  // out-weights coincide
+  for (double sigma : {0.5, 1.0, 1.8}) {
+    Random::set_seed(6);
+    auto edges = chung_lu_directed(n, 2.2, 2.6, 10, 0.5, sigma);
+    CHECK(2.0 * edges.size() / n == doctest::Approx(10).epsilon(0.02));
+    for (unsigned i = 0; i < edges.size(); ++i) {
+      REQUIRE(edges[i].s < n);
+      REQUIRE(edges[i].t < n);
+      REQUIRE(edges[i].s != edges[i].t);
+      if (i > 0) {
+        REQUIRE((edges[i - 1].s < edges[i].s ||
+                 (edges[i - 1].s == edges[i].s &&
+                  edges[i - 1].t < edges[i].t)));
+      }
+    }
+  }
+
+  // the heaviest vertex has the largest in- and out-degree for full
+  // correlation
+  Random::set_seed(6);
+  std::stringstream graph;
+  print_edges_konect(chung_lu_directed(n, 2.5, 2.5, 10, 1.0), DIRECTED, graph);
+  EdgeList EL(graph);
+  CHECK(EL.type() == DIRECTED);
+  unsigned max_in = 0;
+  for (Node v = 0; v < EL.n(); ++v) max_in = std::max(max_in, EL.deg(IN, v));
+  CHECK(EL.deg(IN, 0) == max_in);
+  CHECK(EL.deg(OUT, 0) > EL.deg(OUT, 1));
+}
+
+TEST_CASE("[Random Graph] bipartite chung lu") {
+  unsigned n1 = 20000, n2 = 60000;
+  Random::set_seed(2);
+  auto edges = chung_lu_bipartite(n1, n2, 2.2, 2.8, 6, 0.8);
+  CHECK(2.0 * edges.size() / (n1 + n2) == doctest::Approx(6).epsilon(0.02));
+  for (auto [u, v] : edges) {
+    REQUIRE(u < n1);
+    REQUIRE(v < n2);
+  }
+
+  std::stringstream graph;
+  print_edges_konect(edges, BIPARTITE, graph);
+  EdgeList EL(graph);
+  CHECK(EL.type() == BIPARTITE);
+  CHECK(EL.m() == edges.size());
+}
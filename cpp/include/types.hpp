@@ -29,20 +29,11 @@ struct Edge {
 
 void print_edges(const std::vector<Edge>& edges, std::ostream& out);
 
-template <typename T>
-void print_csv_line_rec(std::ostream& out, const T& val) {
-  out << val;
-}
-
-template <typename T, typename... Args>
-void print_csv_line_rec(std::ostream& out, const T& first,
-                        const Args&... rest) {
-  out << first << ",";
-  print_csv_line_rec(out, rest...);
-}
-
-template <typename... Args>
-void print_csv_line(std::ostream& out, const Args&... args) {
-  print_csv_line_rec(out, args...);
-  out << "\n";
-}
+// Prints the edges in the KONECT format, i.e., with a header line
+// specifying the graph type (such that EdgeList detects it) and with
+// node ids starting at 1.
+void print_edges_konect(const std::vector<Edge>& edges, GraphType type,
+                        std::ostream& out);
+
+// sort edges lexicographically (in parallel)
+void sort_edges(std::vector<Edge>& edges);
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Variable length encoding of natural numbers (7 bits per byte, the
+// highest bit marks that more bytes follow), such that small numbers
+// take only one byte.
+inline void put_varint(std::string& buffer, std::uint64_t x) {
+  while (x >= 0x80) {
+    buffer.push_back(char((x & 0x7f) | 0x80));
+    x >>= 7;
+  }
+  buffer.push_back(char(x));
+}
+
+// Maps integers with small absolute value to small natural numbers (0,
+// -1, 1, -2, ... -> 0, 1, 2, 3, ...), e.g., for storing differences as
+// varints.
+inline std::uint64_t zigzag(std::int64_t x) {
+  return (std::uint64_t(x) << 1) ^ std::uint64_t(x >> 63);
+}
+
+inline std::int64_t unzigzag(std::uint64_t x) {
+  return std::int64_t(x >> 1) ^ -std::int64_t(x & 1);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <omp.h>
+
+#include <cmath>
+#include <vector>
+
+#include "doctest.h"
+
+// Decreasing power-law weights (i + 1)^{-1 / (τ - 1)} for i = 0, ...,
+// n - 1, where τ = ple.
+std::vector<double> power_law_weights(unsigned n, double ple);
+
+// The i-th of the power-law weights to the power of exponent,
+// computed directly from the closed form (instead of keeping all
+// weights in memory).
+inline double power_law_weight(unsigned i, double ple, double exponent = 1) {
+  return std::pow(i + 1.0, -exponent / (ple - 1));
+}
+
+// The powers of the weights used by the connection probabilities of
+// the σ-models (Chung-Lu and AGIRG): w^σ for the lighter and w^min(1,
+// τ - σ) for the heavier endpoint of a pair (copies of the weights for
+// the exponent 1).
+struct SigmaWeights {
+  SigmaWeights(const std::vector<double>& weights, double ple, double sigma);
+
+  std::vector<double> light;
+  std::vector<double> heavy;
+};
+
+// Sum of the values, computed in parallel.  The values are summed in
+// blocks that do not depend on the number of threads, i.e., the
+// result is the same for every number of threads.
+double sum(const std::vector<double>& values);
+
+// Prefix sums of the values: the i-th entry of the result (for i = 0,
+// ..., n) is the sum of the first i values.  Computed in parallel
+// with the same blocks as sum(), i.e., the last entry equals sum().
+std::vector<double> prefix_sums(const std::vector<double>& values);
+
+TEST_CASE("[Weights] powers and sums") {
+  unsigned n = 100000;
+  double ple = 2.3;
+  auto weights = power_law_weights(n, ple);
+  CHECK(weights[0] == 1.0);
+  for (unsigned i = 0; i < n; i += 997) {
+    REQUIRE(weights[i] == doctest::Approx(std::pow(i + 1, -1 / (ple - 1))));
+    REQUIRE(power_law_weight(i, ple) == weights[i]);
+    REQUIRE(power_law_weight(i, ple, 0.7) ==
+            doctest::Approx(std::pow(weights[i], 0.7)));
+  }
+
+  for (double sigma : {0.3, 1.0, 1.8}) {
+    SigmaWeights sw(weights, ple, sigma);
+    for (unsigned i = 0; i < n; i += 997) {
+      REQUIRE(sw.light[i] == doctest::Approx(std::pow(weights[i], sigma)));
+      REQUIRE(sw.heavy[i] == doctest::Approx(std::pow(
+                                 weights[i], std::min(1.0, ple - sigma))));
+    }
+  }
+  // the exponent 1 leaves the weights unchanged
+  CHECK(SigmaWeights(weights, 3.0, 1.0).light == weights);
+
+  auto prefix = prefix_sums(weights);
+  REQUIRE(prefix.size() == n + 1);
+  CHECK(prefix[0] == 0.0);
+  double running = 0.0;
+  for (unsigned i = 0; i < n; ++i) {
+    running += weights[i];
+    REQUIRE(prefix[i + 1] == doctest::Approx(running));
+  }
+  CHECK(prefix[n] == sum(weights));
+
+  // same result for different numbers of threads
+  int nr_threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  double sum1 = sum(weights);
+  omp_set_num_threads(3);
+  double sum3 = sum(weights);
+  omp_set_num_threads(nr_threads);
+  CHECK(sum1 == sum3);
+}
@@ -0,0 +1,309 @@
+#include "agirg_sampler.hpp"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+#include "types.hpp"
+#include "weights.hpp"
+
+namespace {
+
+// Cells are identified by their level and their Morton code, i.e.,
+// the bits of the (integer) cell coordinates are interleaved with the
+// most significant bits first.  The children of cell c on level l are
+// the cells (c << dim) + t (0 <= t < 2^dim) on level l + 1.
+using Cell = std::uint64_t;
+
+// range [begin, end) of indices into the vertices of a layer
+using Range = std::pair<std::size_t, std::size_t>;
+
+Cell cell_of(const Positions& p, Node v, unsigned level) {
+  std::uint64_t cells_per_dim = std::uint64_t(1) << level;
+  Cell cell = 0;
+  for (unsigned b = level; b-- > 0;) {
+    for (unsigned d = 0; d < p.dim; ++d) {
+      auto x = std::min(cells_per_dim - 1,
+                        std::uint64_t(p.coord(v, d) * cells_per_dim));
+      cell = (cell << 1) | ((x >> b) & 1);
+    }
+  }
+  return cell;
+}
+
+// The vertices of one weight layer, sorted by the cell (on the level
+// of the layer) containing them.
+struct Layer {
+  unsigned level = 0;
+  double max_weight = 0.0;
+  std::vector<Node> vertices;
+  // the vertices in cell c are vertices[cell_begin[c]], ...,
+  // vertices[cell_begin[c + 1] - 1]
+  std::vector<std::size_t> cell_begin;
+
+  // the vertices in a cell on a level <= level
+  Range range(Cell cell, unsigned cell_level, unsigned dim) const {
+    unsigned shift = dim * (level - cell_level);
+    return {cell_begin[cell << shift], cell_begin[(cell + 1) << shift]};
+  }
+
+  // sort the vertices by cell (counting sort)
+  void sort(const Positions& p) {
+    std::size_t nr_cells = std::size_t(1) << (p.dim * level);
+    std::vector<Cell> cells(vertices.size());
+    cell_begin.assign(nr_cells + 1, 0);
+    for (std::size_t i = 0; i < vertices.size(); ++i) {
+      cells[i] = cell_of(p, vertices[i], level);
+      cell_begin[cells[i] + 1]++;
+    }
+    std::partial_sum(cell_begin.begin(), cell_begin.end(), cell_begin.begin());
+    std::vector<Node> sorted(vertices.size());
+    std::vector<std::size_t> pos(cell_begin.begin(), cell_begin.end() - 1);
+    for (std::size_t i = 0; i < vertices.size(); ++i) {
+      sorted[pos[cells[i]]++] = vertices[i];
+    }
+    vertices = std::move(sorted);
+  }
+};
+
+// Connection probabilities of the AGIRG.
+struct Model {
+  const Positions& positions;
+  std::vector<double> weights_heavy;
+  std::vector<double> weights_sigma;
+  double W;
+  double alpha;
+
+  double w_part(Node u, Node v) const {
+    // the vertex with smaller index is the heavier one
+    if (u > v) std::swap(u, v);
+    return weights_sigma[v] * weights_heavy[u] / W;
+  }
+
+  double dist_part(Node u, Node v) const {
+    return std::pow(distance(positions, u, v), positions.dim);
+  }
+};
+
+// Samples the edges between the vertices of two layers (or within a
+// layer if both are the same).
+class LayerPairSampler {
+ public:
+  LayerPairSampler(const Model& model, const Layer& layer1,
+                   const Layer& layer2, double max_w_part, unsigned level,
+                   std::uint64_t seed)
+      : m_model(model),
+        m_layer1(layer1),
+        m_layer2(layer2),
+        m_same_layer(&layer1 == &layer2),
+        m_dim(model.positions.dim),
+        m_max_w_part(max_w_part),
+        m_level(level),
+        m_coords1((level + 1) * m_dim, 0),
+        m_coords2((level + 1) * m_dim, 0),
+        m_rng(seed) {}
+
+  std::vector<Edge> sample() {
+    visit(0, 0, 0);
+    return std::move(m_edges);
+  }
+
+ private:
+  // Vertices of layer1 in cell c1 and vertices of layer2 in cell c2.
+  // For a single layer, each unordered pair of cells is visited once.
+  // The integer coordinates of the cells are stored in m_coords1 and
+  // m_coords2 (at index level * dim + d for the d-th coordinate).
+  void visit(Cell c1, Cell c2, unsigned level) {
+    const std::uint64_t* x1 = &m_coords1[level * m_dim];
+    const std::uint64_t* x2 = &m_coords2[level * m_dim];
+
+    // number of cells between c1 and c2 (on the torus)
+    std::uint64_t cells_per_dim = std::uint64_t(1) << level;
+    std::uint64_t gap = 0;
+    for (unsigned d = 0; d < m_dim; ++d) {
+      std::uint64_t diff = x1[d] > x2[d] ? x1[d] - x2[d] : x2[d] - x1[d];
+      gap = std::max(gap, std::min(diff, cells_per_dim - diff));
+    }
+    // for T = 0, vertices in non-touching cells are never connected
+    if (gap > 1 && m_model.alpha == std::numeric_limits<double>::infinity()) {
+      return;
+    }
+
+    Range r1 = m_layer1.range(c1, level, m_dim);
+    Range r2 = m_layer2.range(c2, level, m_dim);
+    if (r1.first == r1.second || r2.first == r2.second) return;
+
+    if (gap > 1) {
+      type_II(r1, r2, double(gap - 1) / cells_per_dim);
+      return;
+    }
+    if (level == m_level) {
+      type_I(r1, r2, m_same_layer && c1 == c2);
+      return;
+    }
+
+    // children: the bits of t are the lowest bits of the coordinates
+    std::uint64_t* y1 = &m_coords1[(level + 1) * m_dim];
+    std::uint64_t* y2 = &m_coords2[(level + 1) * m_dim];
+    Cell children = Cell(1) << m_dim;
+    for (Cell t1 = 0; t1 < children; ++t1) {
+      for (unsigned d = 0; d < m_dim; ++d) {
+        y1[d] = 2 * x1[d] + ((t1 >> (m_dim - 1 - d)) & 1);
+      }
+      for (Cell t2 = m_same_layer && c1 == c2 ? t1 : 0; t2 < children; ++t2) {
+        for (unsigned d = 0; d < m_dim; ++d) {
+          y2[d] = 2 * x2[d] + ((t2 >> (m_dim - 1 - d)) & 1);
+        }
+        visit((c1 << m_dim) + t1, (c2 << m_dim) + t2, level + 1);
+      }
+    }
+  }
+
+  // pairs of vertices in touching cells: check each pair
+  void type_I(Range r1, Range r2, bool same_cell) {
+    for (std::size_t i = r1.first; i < r1.second; ++i) {
+      Node u = m_layer1.vertices[i];
+      for (std::size_t j = same_cell ? i + 1 : r2.first; j < r2.second; ++j) {
+        Node v = m_layer2.vertices[j];
+        double w_part = m_model.w_part(u, v);
+        double dist_part = m_model.dist_part(u, v);
+        if (m_model.alpha == std::numeric_limits<double>::infinity()) {
+          if (dist_part < w_part) add_edge(u, v);
+        } else if (m_rng.coin_flip(
+                       std::pow(w_part / dist_part, m_model.alpha))) {
+          add_edge(u, v);
+        }
+      }
+    }
+  }
+
+  // pairs of vertices in non-touching cells: jump directly to the
+  // next pair that is a candidate with respect to an upper bound on
+  // the connection probability
+  void type_II(Range r1, Range r2, double min_dist) {
+    // the upper bound is at most 1 due to the choice of the level and
+    // for T = 0, no such pair is connected
+    if (m_model.alpha == std::numeric_limits<double>::infinity()) return;
+    double max_p = std::min(
+        1.0, std::pow(m_max_w_part / std::pow(min_dist, m_dim), m_model.alpha));
+    if (max_p <= 0.0) return;
+
+    std::size_t size2 = r2.second - r2.first;
+    double nr_pairs = double(r1.second - r1.first) * size2;
+    double log_not_p = std::log1p(-max_p);
+    for (double k = -1;;) {
+      k += 1;
+      if (max_p < 1.0) {
+        k += std::floor(std::log1p(-m_rng.uniform()) / log_not_p);
+      }
+      if (k >= nr_pairs) break;
+      auto index = std::size_t(k);
+      Node u = m_layer1.vertices[r1.first + index / size2];
+      Node v = m_layer2.vertices[r2.first + index % size2];
+      double p = std::pow(m_model.w_part(u, v) / m_model.dist_part(u, v),
+                          m_model.alpha);
+      if (m_rng.coin_flip(p / max_p)) add_edge(u, v);
+    }
+  }
+
+  void add_edge(Node u, Node v) {
+    m_edges.push_back({std::min(u, v), std::max(u, v)});
+  }
+
+  const Model& m_model;
+  const Layer& m_layer1;
+  const Layer& m_layer2;
+  bool m_same_layer;
+  unsigned m_dim;
+  // upper bound on the weight part of pairs from the two layers
+  double m_max_w_part;
+  // level on which the type I pairs are checked
+  unsigned m_level;
+  std::vector<std::uint64_t> m_coords1;
+  std::vector<std::uint64_t> m_coords2;
+  RandomStream m_rng;
+  std::vector<Edge> m_edges;
+};
+
+}  // namespace
+
+std::vector<Edge> agirg_edges(const std::vector<double>& weights,
+                              const Positions& positions, double ple,
+                              double sigma, double T, std::uint64_t seed) {
+  unsigned n = weights.size();
+  unsigned dim = positions.dim;
+  if (n == 0) return {};
+
+  SigmaWeights powers(weights, ple, sigma);
+  Model model{positions, std::move(powers.heavy), std::move(powers.light),
+              sum(weights),
+              T > 0 ? 1 / T : std::numeric_limits<double>::infinity()};
+  double exponent_heavy = std::min(1.0, ple - sigma);
+
+  // weight layers: layer i contains the weights in [2^i w_min, 2^{i +
+  // 1} w_min), i.e., the lower layers have the lighter vertices
+  double min_weight = weights[n - 1];
+  auto layer_of = [&](double w) {
+    return unsigned(std::max(0.0, std::floor(std::log2(w / min_weight))));
+  };
+  std::vector<Layer> layers(layer_of(weights[0]) + 1);
+  for (Node v = 0; v < n; ++v) {
+    Layer& layer = layers[layer_of(weights[v])];
+    layer.vertices.push_back(v);
+    layer.max_weight = std::max(layer.max_weight, weights[v]);
+  }
+
+  // Level for each pair of layers: the finest level whose cells have
+  // a volume of at least the maximum weight part, but with no more
+  // cells than vertices.
+  unsigned max_level = std::floor(std::log2(n) / dim);
+  unsigned nr_layers = layers.size();
+  std::vector<double> max_w_part(nr_layers * nr_layers, 0.0);
+  std::vector<unsigned> level(nr_layers * nr_layers, 0);
+  for (unsigned i = 0; i < nr_layers; ++i) {
+    for (unsigned j = 0; j <= i; ++j) {
+      if (layers[i].vertices.empty() || layers[j].vertices.empty()) continue;
+      double bound = std::pow(layers[i].max_weight, exponent_heavy) *
+                     std::pow(layers[j].max_weight, sigma) / model.W;
+      unsigned l = bound >= 1.0 ? 0
+                                : std::min<double>(max_level,
+                                                   -std::log2(bound) / dim);
+      max_w_part[i * nr_layers + j] = bound;
+      level[i * nr_layers + j] = l;
+      layers[i].level = std::max(layers[i].level, l);
+      layers[j].level = std::max(layers[j].level, l);
+    }
+  }
+
+#pragma omp parallel for schedule(dynamic)
+  for (unsigned i = 0; i < nr_layers; ++i) {
+    layers[i].sort(positions);
+  }
+
+  // sample the layer pairs in parallel (with one random stream each)
+  std::vector<std::vector<Edge>> edges_by_pair(nr_layers * nr_layers);
+#pragma omp parallel for schedule(dynamic)
+  for (unsigned pair = 0; pair < nr_layers * nr_layers; ++pair) {
+    unsigned i = pair / nr_layers, j = pair % nr_layers;
+    if (j > i || layers[i].vertices.empty() || layers[j].vertices.empty()) {
+      continue;
+    }
+    LayerPairSampler sampler(model, layers[i], layers[j], max_w_part[pair],
+                             level[pair], substream_seed(seed, pair));
+    edges_by_pair[pair] = sampler.sample();
+  }
+
+  std::vector<Edge> edges;
+  for (auto& pair_edges : edges_by_pair) {
+    edges.insert(edges.end(), pair_edges.begin(), pair_edges.end());
+    pair_edges = {};
+  }
+
+  // canonical order of the edges
+  sort_edges(edges);
+  return edges;
+}
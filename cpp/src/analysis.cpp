@@ -0,0 +1,289 @@
+#include "analysis.hpp"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binary_table.hpp"
+#include "csv_writer.hpp"
+#include "histogram.hpp"
+#include "kendall.hpp"
+#include "pearson.hpp"
+#include "spearman.hpp"
+#include "types.hpp"
+
+void print_stats(const EdgeList& EL, std::ostream& out) {
+  std::vector<std::pair<DegType, DegType>> variants;
+  switch (EL.type()) {
+    case UNDIRECTED:
+      variants = {{SUM, SUM}};
+      break;
+    case BIPARTITE:
+      variants = {{OUT, IN}};
+      break;
+    case DIRECTED:
+      variants = {{OUT, IN}, {IN, OUT}, {OUT, OUT}, {IN, IN}, {SUM, SUM}};
+  }
+
+  CsvWriter csv(out);
+  for (auto [source_type, target_type] : variants) {
+    auto points = EL.degree_points(source_type, target_type);
+    Kendall K(points, EL.type() == UNDIRECTED);
+    print_csv_line(csv,
+                   // basic stats
+                   name(EL.type()), EL.n(), EL.n1(), EL.n2(), EL.m(),
+                   // assortativity
+                   name(source_type), name(target_type),  //
+                   pearson(points), spearman(points),     //
+                   K.tau_a(), K.tau_b(), K.tau_simple(),  //
+                   K.concordant(), K.discordant(), K.ties_x(), K.ties_y(),
+                   K.ties_both());
+  }
+}
+
+namespace {
+
+// distribution of the vertex degrees (for bipartite graphs, the out-
+// and in-degrees of the two partitions)
+Histogram vertex_degrees(const EdgeList& EL) {
+  std::vector<unsigned> degrees(EL.n());
+  if (EL.type() == BIPARTITE) {
+    unsigned n1 = EL.n1();
+#pragma omp parallel for
+    for (Node v = 0; v < n1; ++v) degrees[v] = EL.deg(OUT, v);
+#pragma omp parallel for
+    for (Node v = 0; v < EL.n2(); ++v) degrees[n1 + v] = EL.deg(IN, v);
+  } else {
+#pragma omp parallel for
+    for (Node v = 0; v < EL.n(); ++v) degrees[v] = EL.deg(SUM, v);
+  }
+  return Histogram(degrees);
+}
+
+}  // namespace
+
+void print_degree_distribution(const EdgeList& EL, std::ostream& out,
+                               bool edge_endpoints, unsigned nr_buckets,
+                               unsigned bucket) {
+  if (edge_endpoints) {
+    print_bucketed_degree_distributions(EL, out, nr_buckets, {bucket});
+    return;
+  }
+
+  // degree distribution (random vertex)
+  Histogram H_deg = vertex_degrees(EL);
+  CsvWriter csv(out);
+  for (unsigned deg = 0; deg <= H_deg.maximum(); ++deg) {
+    if (H_deg.frequency(deg) > 0) {
+      print_csv_line(csv, deg, H_deg.frequency(deg), false, nr_buckets, bucket,
+                     0, 0);
+    }
+  }
+}
+
+void print_bucketed_degree_distributions(const EdgeList& EL, std::ostream& out,
+                                         unsigned nr_buckets,
+                                         const std::vector<unsigned>& buckets) {
+  // logarithmic breaks -> upper and lower bounds for neighbor degree
+  unsigned max_deg = vertex_degrees(EL).maximum();
+  auto breaks = log_breaks(1, max_deg + 1, nr_buckets);
+
+  // Lookup table: degree d lies in the buckets first[d], ...,
+  // last[d], i.e., in the buckets b with breaks[b] <= d <= breaks[b +
+  // 1] (both bounds are inclusive, such that a degree on a break
+  // belongs to both adjacent buckets).
+  std::vector<unsigned> first(max_deg + 1, nr_buckets), last(max_deg + 1, 0);
+  for (unsigned b = 0; b < nr_buckets; ++b) {
+    auto d = unsigned(std::ceil(breaks[b]));
+    for (; d <= max_deg && d <= breaks[b + 1]; ++d) {
+      first[d] = std::min(first[d], b);
+      last[d] = b;
+    }
+  }
+
+  // one row of counters (indexed by degree) per requested bucket
+  assert(std::all_of(buckets.begin(), buckets.end(),
+                     [&](unsigned b) { return b < nr_buckets; }));
+  const unsigned none = buckets.size();
+  std::vector<unsigned> row(nr_buckets, none);
+  for (unsigned i = buckets.size(); i-- > 0;) row[buckets[i]] = i;
+  const std::size_t size = buckets.size() * std::size_t(max_deg + 1);
+
+  // count each endpoint for the buckets of the other endpoint (each
+  // thread in its own counters, which are added up afterwards)
+  std::vector<std::vector<std::uint64_t>> local(omp_get_max_threads());
+  const auto& edges = EL.edges();
+#pragma omp parallel
+  {
+    auto& count = local[omp_get_thread_num()];
+    count.assign(size, 0);
+    auto add = [&](unsigned deg, unsigned neighbor_deg) {
+      for (unsigned b = first[neighbor_deg]; b <= last[neighbor_deg]; ++b) {
+        if (row[b] != none) count[row[b] * std::size_t(max_deg + 1) + deg]++;
+      }
+    };
+#pragma omp for
+    for (std::size_t i = 0; i < edges.size(); ++i) {
+      const Edge& e = edges[i];
+      unsigned deg_s =
+          EL.type() != BIPARTITE ? EL.deg(SUM, e.s) : EL.deg(OUT, e.s);
+      unsigned deg_t =
+          EL.type() != BIPARTITE ? EL.deg(SUM, e.t) : EL.deg(IN, e.t);
+      add(deg_t, deg_s);
+      add(deg_s, deg_t);
+    }
+  }
+  std::vector<std::uint64_t> count(size, 0);
+#pragma omp parallel for
+  for (std::size_t i = 0; i < size; ++i) {
+    for (const auto& local_count : local) {
+      if (!local_count.empty()) count[i] += local_count[i];
+    }
+  }
+
+  CsvWriter csv(out);
+  for (unsigned bucket : buckets) {
+    const std::uint64_t* frequency = &count[row[bucket] * (max_deg + 1)];
+    for (unsigned deg = 0; deg <= max_deg; ++deg) {
+      if (frequency[deg] > 0) {
+        print_csv_line(csv, deg, frequency[deg], true, nr_buckets, bucket,
+                       breaks[bucket], breaks[bucket + 1]);
+      }
+    }
+  }
+}
+
+bool valid_buckets(const std::vector<unsigned>& buckets, unsigned nr_buckets) {
+  for (unsigned bucket : buckets) {
+    if (bucket >= nr_buckets) {
+      std::cerr << "ERROR: bucket " << bucket << " does not exist (there are "
+                << nr_buckets << " buckets, numbered from 0)." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+void print_degree_distributions(const EdgeList& EL, std::ostream& out,
+                                unsigned nr_buckets,
+                                const std::vector<unsigned>& buckets) {
+  print_degree_distribution(EL, out);
+  print_degree_distribution(EL, out, true);
+  print_bucketed_degree_distributions(EL, out, nr_buckets, buckets);
+}
+
+namespace {
+
+void write_joint_histogram(const Histogram2D& H, std::ostream& out,
+                           unsigned nr_buckets, bool complementary_cumulative) {
+  CsvWriter csv(out);
+  for (unsigned x = 0; x < nr_buckets; ++x) {
+    for (unsigned y = 0; y < nr_buckets; ++y) {
+      print_csv_line(csv,                                  //
+                     H.lb_x(x), H.ub_x(x), H.center_x(x),  //
+                     H.lb_y(y), H.ub_y(y), H.center_y(y),  //
+                     H.count(x, y),                        //
+                     nr_buckets, complementary_cumulative);
+    }
+  }
+}
+
+// the column names of a csv header
+std::vector<std::string> column_names(const std::string& header) {
+  std::vector<std::string> names;
+  std::istringstream stream(header);
+  std::string name;
+  while (std::getline(stream, name, ',')) names.push_back(name);
+  return names;
+}
+
+}  // namespace
+
+std::vector<Point> joint_degree_points(const EdgeList& EL) {
+  return EL.type() != BIPARTITE ? EL.degree_points(SUM, SUM)
+                                : EL.degree_points(OUT, IN);
+}
+
+void print_joint_histogram(const EdgeList& EL, std::ostream& out,
+                           unsigned nr_buckets,
+                           bool complementary_cumulative) {
+  print_joint_histogram(joint_degree_points(EL), out, nr_buckets,
+                        complementary_cumulative);
+}
+
+void print_joint_histogram(const std::vector<Point>& points,
+                           std::ostream& out, unsigned nr_buckets,
+                           bool complementary_cumulative) {
+  Histogram2D H{points, nr_buckets, complementary_cumulative};
+  write_joint_histogram(H, out, nr_buckets, complementary_cumulative);
+}
+
+void print_joint_histograms(const EdgeList& EL, std::ostream& out,
+                            const std::vector<unsigned>& nr_buckets,
+                            const std::vector<bool>& complementary_cumulative) {
+  // exact joint degree table, from which each histogram is computed
+  // in time linear in the number of distinct degree pairs
+  auto counts = count_points(joint_degree_points(EL));
+  for (unsigned nr : nr_buckets) {
+    for (bool cumulative : complementary_cumulative) {
+      Histogram2D H{counts, nr, cumulative};
+      write_joint_histogram(H, out, nr, cumulative);
+    }
+  }
+}
+
+void print_joint_degree_distr(const std::vector<Point>& points,
+                              std::ostream& out, TableFormat format) {
+  auto counts = count_points(points);
+  if (format != CSV) {
+    std::vector<std::uint32_t> x(counts.size()), y(counts.size());
+    std::vector<std::uint64_t> count(counts.size());
+#pragma omp parallel for
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+      x[i] = counts[i].point.x;
+      y[i] = counts[i].point.y;
+      count[i] = counts[i].count;
+    }
+    auto names = column_names(joint_degree_distr_header);
+    BinaryTableWriter table(format == COMPRESSED);
+    table.add_column(names[0], x);
+    table.add_column(names[1], y);
+    table.add_column(names[2], count);
+    table.write(out);
+    return;
+  }
+  CsvWriter csv(out);
+  for (const PointCount& c : counts) {
+    print_csv_line(csv, c.point.x, c.point.y, c.count);
+  }
+}
+
+void print_edge_degrees(const std::vector<Point>& points, std::ostream& out,
+                        TableFormat format) {
+  if (format != CSV) {
+    std::vector<std::uint32_t> x(points.size()), y(points.size());
+#pragma omp parallel for
+    for (std::size_t i = 0; i < points.size(); ++i) {
+      x[i] = points[i].x;
+      y[i] = points[i].y;
+    }
+    auto names = column_names(edge_degrees_header);
+    BinaryTableWriter table(format == COMPRESSED);
+    table.add_column(names[0], x);
+    table.add_column(names[1], y);
+    table.write(out);
+    return;
+  }
+  CsvWriter csv(out);
+  for (const Point& p : points) {
+    print_csv_line(csv, p.x, p.y);
+  }
+}
@@ -0,0 +1,108 @@
+#include "binary_edges.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+#include "varint.hpp"
+
+namespace {
+
+const char magic[8] = {'\0', 'E', 'D', 'G', 'E', 'S', 'D', 'V'};
+
+[[noreturn]] void invalid_input(const std::string& reason) {
+  std::cerr << "ERROR: invalid binary edge list (" << reason << ")."
+            << std::endl;
+  exit(1);
+}
+
+}  // namespace
+
+BinaryEdgeWriter::BinaryEdgeWriter(std::ostream& out, GraphType type,
+                                   std::uint64_t n)
+    : m_out(out) {
+  m_buffer.append(magic, sizeof(magic));
+  m_buffer.push_back(char(type));
+  for (unsigned i = 0; i < 8; ++i) m_buffer.push_back(char(n >> (8 * i)));
+  m_out.write(m_buffer.data(), m_buffer.size());
+  m_buffer.clear();
+}
+
+void BinaryEdgeWriter::write(const std::vector<Edge>& edges) {
+  m_buffer.clear();
+  m_buffer.reserve(3 * edges.size());
+  for (const Edge& e : edges) {
+    bool first = m_m == 0;
+    assert(first || e.s > m_prev.s || (e.s == m_prev.s && e.t > m_prev.t));
+    put_varint(m_buffer, e.s - m_prev.s);
+    if (!first && e.s == m_prev.s) {
+      put_varint(m_buffer, e.t - m_prev.t);
+    } else {
+      put_varint(m_buffer, zigzag(std::int64_t(e.t) - std::int64_t(e.s)));
+    }
+    m_prev = e;
+    m_m++;
+  }
+  m_out.write(m_buffer.data(), m_buffer.size());
+}
+
+BinaryEdgeReader::BinaryEdgeReader(std::istream& in) : m_in(in) {
+  char header[sizeof(magic) + 9];
+  if (!m_in.read(header, sizeof(header))) invalid_input("incomplete header");
+  if (std::memcmp(header, magic, sizeof(magic)) != 0) {
+    invalid_input("wrong magic bytes");
+  }
+  m_type = GraphType(header[sizeof(magic)]);
+  if (m_type != UNDIRECTED && m_type != DIRECTED && m_type != BIPARTITE) {
+    invalid_input("unknown graph type");
+  }
+  m_n = 0;
+  for (unsigned i = 0; i < 8; ++i) {
+    m_n |= std::uint64_t(std::uint8_t(header[sizeof(magic) + 1 + i]))
+           << (8 * i);
+  }
+}
+
+std::uint64_t BinaryEdgeReader::read_varint() {
+  std::uint64_t x = 0;
+  for (unsigned shift = 0;; shift += 7) {
+    auto byte = m_in.rdbuf()->sbumpc();
+    if (byte == std::istream::traits_type::eof()) {
+      m_in.setstate(std::ios::eofbit);
+      return 0;
+    }
+    if (shift >= 64) invalid_input("varint too long");
+    x |= std::uint64_t(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) return x;
+  }
+}
+
+bool BinaryEdgeReader::next(Edge& edge) {
+  // the input may only end before an edge
+  if (m_in.rdbuf()->sgetc() == std::istream::traits_type::eof()) {
+    m_in.setstate(std::ios::eofbit);
+    return false;
+  }
+  std::uint64_t ds = read_varint();
+  std::uint64_t dt = read_varint();
+  if (m_in.eof()) invalid_input("incomplete last edge");
+  // decoded in 64 bits to detect ids that do not fit into a Node
+  // (the bounds on the differences rule out overflows)
+  constexpr std::int64_t max_node = std::numeric_limits<Node>::max();
+  if (ds > std::uint64_t(max_node) || dt > std::uint64_t(2 * max_node + 1)) {
+    invalid_input("vertex id out of range");
+  }
+  std::int64_t s = m_prev.s + std::int64_t(ds);
+  std::int64_t t = !m_first && ds == 0 ? m_prev.t + std::int64_t(dt)
+                                       : s + unzigzag(dt);
+  if (s > max_node || t < 0 || t > max_node) {
+    invalid_input("vertex id out of range");
+  }
+  edge.s = s;
+  edge.t = t;
+  m_prev = edge;
+  m_first = false;
+  return true;
+}
@@ -0,0 +1,168 @@
+#include "binary_table.hpp"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+#include "varint.hpp"
+
+namespace {
+
+const char magic[8] = {'\0', 'C', 'O', 'L', 'U', 'M', 'N', 'S'};
+
+// rows per chunk that is encoded by one thread
+constexpr std::size_t chunk_size = 1 << 16;
+
+void put_fixed(std::string& buffer, std::uint64_t x, unsigned width) {
+  for (unsigned i = 0; i < width; ++i) buffer.push_back(char(x >> (8 * i)));
+}
+
+unsigned varint_length(std::uint64_t x) {
+  return (std::bit_width(x | 1) + 6) / 7;
+}
+
+std::uint64_t delta(std::uint64_t x, std::uint64_t prev) {
+  return zigzag(std::int64_t(x - prev));
+}
+
+struct Layout {
+  unsigned width;
+  BinaryTableWriter::Encoding encoding;
+  std::uint64_t size;
+};
+
+// width of the largest value and the encoding with the smallest size
+template <typename T>
+Layout layout(std::span<const T> values, bool compress) {
+  std::uint64_t max = 0, delta_size = 0, varint_size = 0;
+#pragma omp parallel for reduction(max : max) \
+    reduction(+ : delta_size, varint_size)
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    max = std::max<std::uint64_t>(max, values[i]);
+    if (compress) {
+      varint_size += varint_length(values[i]);
+      delta_size += varint_length(delta(values[i], i > 0 ? values[i - 1] : 0));
+    }
+  }
+  unsigned width = std::max<unsigned>(1, (std::bit_width(max) + 7) / 8);
+  if (!compress) {
+    return {width, BinaryTableWriter::PLAIN, width * values.size()};
+  }
+  if (delta_size < varint_size) {
+    return {width, BinaryTableWriter::DELTA, delta_size};
+  }
+  return {width, BinaryTableWriter::VARINT, varint_size};
+}
+
+template <unsigned Width, typename T>
+void put_plain(std::string& buffer, std::span<const T> values) {
+  std::size_t pos = buffer.size();
+  buffer.resize(pos + Width * values.size());
+  for (T x : values) {
+    for (unsigned i = 0; i < Width; ++i) {
+      buffer[pos++] = char(std::uint64_t(x) >> (8 * i));
+    }
+  }
+}
+
+// encodes the rows first, ..., last - 1
+template <typename T>
+void encode_chunk(std::string& buffer, std::span<const T> values,
+                  std::size_t first, std::size_t last, const Layout& layout) {
+  buffer.clear();
+  auto chunk = values.subspan(first, last - first);
+  switch (layout.encoding) {
+    case BinaryTableWriter::PLAIN:
+      switch (layout.width) {
+        case 1: return put_plain<1>(buffer, chunk);
+        case 2: return put_plain<2>(buffer, chunk);
+        case 3: return put_plain<3>(buffer, chunk);
+        case 4: return put_plain<4>(buffer, chunk);
+        case 5: return put_plain<5>(buffer, chunk);
+        case 6: return put_plain<6>(buffer, chunk);
+        case 7: return put_plain<7>(buffer, chunk);
+        default: return put_plain<8>(buffer, chunk);
+      }
+    case BinaryTableWriter::DELTA: {
+      std::uint64_t prev = first > 0 ? values[first - 1] : 0;
+      for (T x : chunk) {
+        put_varint(buffer, delta(x, prev));
+        prev = x;
+      }
+      return;
+    }
+    case BinaryTableWriter::VARINT:
+      for (T x : chunk) put_varint(buffer, x);
+      return;
+  }
+}
+
+// encodes the column in batches of chunks (one batch in parallel) and
+// writes each batch
+template <typename T>
+void write_column(std::ostream& out, std::span<const T> values,
+                  const Layout& layout) {
+  std::size_t nr_chunks = (values.size() + chunk_size - 1) / chunk_size;
+  std::vector<std::string> buffers(4 * omp_get_max_threads());
+  for (std::size_t batch = 0; batch < nr_chunks; batch += buffers.size()) {
+    std::size_t batch_size = std::min(buffers.size(), nr_chunks - batch);
+#pragma omp parallel for schedule(dynamic, 1)
+    for (std::size_t i = 0; i < batch_size; ++i) {
+      std::size_t first = (batch + i) * chunk_size;
+      encode_chunk(buffers[i], values, first,
+                   std::min(values.size(), first + chunk_size), layout);
+    }
+    for (std::size_t i = 0; i < batch_size; ++i) {
+      out.write(buffers[i].data(), buffers[i].size());
+    }
+  }
+}
+
+}  // namespace
+
+BinaryTableWriter::BinaryTableWriter(bool compress) : m_compress(compress) {}
+
+void BinaryTableWriter::add_column(const std::string& name,
+                                   std::span<const std::uint32_t> values) {
+  m_columns.push_back({name, values});
+}
+
+void BinaryTableWriter::add_column(const std::string& name,
+                                   std::span<const std::uint64_t> values) {
+  m_columns.push_back({name, values});
+}
+
+void BinaryTableWriter::write(std::ostream& out) const {
+  assert(m_columns.size() < 256);
+  std::uint64_t nr_rows = 0;
+  if (!m_columns.empty()) {
+    nr_rows = std::visit([](auto v) { return v.size(); }, m_columns[0].values);
+  }
+
+  std::string header(magic, sizeof(magic));
+  put_fixed(header, nr_rows, 8);
+  header.push_back(char(m_columns.size()));
+  std::vector<Layout> layouts;
+  for (const Column& column : m_columns) {
+    assert(column.name.size() < 256);
+    layouts.push_back(std::visit(
+        [&](auto values) {
+          assert(values.size() == nr_rows);
+          return layout(values, m_compress);
+        },
+        column.values));
+    header.push_back(char(column.name.size()));
+    header += column.name;
+    header.push_back(char(layouts.back().width));
+    header.push_back(char(layouts.back().encoding));
+    put_fixed(header, layouts.back().size, 8);
+  }
+  out.write(header.data(), header.size());
+
+  for (std::size_t i = 0; i < m_columns.size(); ++i) {
+    std::visit([&](auto values) { write_column(out, values, layouts[i]); },
+               m_columns[i].values);
+  }
+}
@@ -0,0 +1,203 @@
+#include "calibration.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+WeightClasses::WeightClasses(const std::vector<double>& weights,
+                             double max_ratio)
+    : m_begin{0} {
+  for (unsigned v = 1; v < weights.size(); ++v) {
+    if (weights[m_begin.back()] > max_ratio * weights[v]) {
+      m_begin.push_back(v);
+    }
+  }
+  m_begin.push_back(weights.size());
+}
+
+std::vector<double> WeightClasses::sums(
+    const std::vector<double>& values) const {
+  std::vector<double> res(size(), 0.0);
+#pragma omp parallel for schedule(dynamic, 64)
+  for (unsigned c = 0; c < size(); ++c) {
+    for (unsigned v = begin(c); v < end(c); ++v) {
+      res[c] += values[v];
+    }
+  }
+  return res;
+}
+
+std::vector<double> WeightClasses::power_sums(
+    const std::vector<double>& weights, double exponent) const {
+  std::vector<double> res(size(), 0.0);
+#pragma omp parallel for schedule(dynamic, 64)
+  for (unsigned c = 0; c < size(); ++c) {
+    for (unsigned v = begin(c); v < end(c); ++v) {
+      res[c] += exponent == 1.0 ? weights[v] : std::pow(weights[v], exponent);
+    }
+  }
+  return res;
+}
+
+double find_root(const std::function<double(double)>& f, double target,
+                 double x, double rel_tol) {
+  auto error = [&](double x) { return f(x) - target; };
+  auto done = [&](double err) { return std::abs(err) <= rel_tol * target; };
+
+  // bracket the root; the target may be out of reach (e.g., an average
+  // degree of at least n - 1), f(x) may then also become NaN
+  const int max_steps = 256;
+  double lo = x, hi = x;
+  double err_lo = error(lo), err_hi = err_lo;
+  for (int i = 0; err_hi < 0 && i < max_steps; ++i) {
+    lo = hi;
+    err_lo = err_hi;
+    hi *= 2;
+    err_hi = error(hi);
+  }
+  for (int i = 0; err_lo > 0 && i < max_steps; ++i) {
+    hi = lo;
+    err_hi = err_lo;
+    lo /= 2;
+    err_lo = error(lo);
+  }
+  if (!(err_lo <= 0 && err_hi >= 0)) {
+    std::cerr << "ERROR: calibration failed, the target value " << target
+              << " cannot be reached (e.g., the average degree is too "
+                 "large for the number of vertices)."
+              << std::endl;
+    exit(1);
+  }
+  if (done(err_lo)) return lo;
+  if (done(err_hi)) return hi;
+
+  // Illinois algorithm: secant steps within the bracket; halving the
+  // error of an endpoint that is retained twice in a row prevents slow
+  // convergence from one side
+  int retained = 0;
+  for (int i = 0; i < 200 && hi - lo > hi * 1e-15; ++i) {
+    double mid = (lo * err_hi - hi * err_lo) / (err_hi - err_lo);
+    double err_mid = error(mid);
+    if (done(err_mid)) return mid;
+    if (err_mid < 0) {
+      lo = mid;
+      err_lo = err_mid;
+      if (retained > 0) err_hi /= 2;
+      retained = retained > 0 ? retained + 1 : 1;
+    } else {
+      hi = mid;
+      err_hi = err_mid;
+      if (retained < 0) err_lo /= 2;
+      retained = retained < 0 ? retained - 1 : -1;
+    }
+  }
+  return (lo + hi) / 2;
+}
+
+AgirgEdgeEstimator::AgirgEdgeEstimator(const std::vector<double>& weights,
+                                       double ple, double sigma, unsigned dim,
+                                       double T, double max_ratio)
+    : m_classes(weights, max_ratio),
+      m_alpha(T > 0 ? 1 / T : std::numeric_limits<double>::infinity()) {
+  // weights to the power of min(1, τ - σ) (heavier endpoint) and σ
+  // (lighter endpoint), averaged over each class
+  SigmaWeights powers(weights, ple, sigma);
+  m_avg_heavy = m_classes.sums(powers.heavy);
+  m_avg_sigma = m_classes.sums(powers.light);
+  for (unsigned c = 0; c < m_classes.size(); ++c) {
+    m_avg_heavy[c] /= m_classes.count(c);
+    m_avg_sigma[c] /= m_classes.count(c);
+  }
+
+  // the distance part of the connection probability (volume of a
+  // ball) is uniformly distributed in [0, 2^{-dim}] -> rescale the
+  // weight part to make it uniform in [0, 1]
+  m_normalization = std::pow(2.0, dim) / sum(weights);
+}
+
+double AgirgEdgeEstimator::probability(double x) const {
+  if (x >= 1.0) return 1.0;
+  // T = 0: threshold
+  if (m_alpha == std::numeric_limits<double>::infinity()) return x;
+  // T > 0: integrating min(1, (x / d)^α) over d in [0, 1]
+  if (m_alpha == 1.0) return x * (1 - std::log(x));
+  return (m_alpha * x - std::pow(x, m_alpha)) / (m_alpha - 1);
+}
+
+double AgirgEdgeEstimator::operator()(double factor) const {
+  double scale = factor * m_normalization;
+  double expected_edges = 0.0;
+#pragma omp parallel for schedule(dynamic, 16) reduction(+ : expected_edges)
+  for (unsigned i = 0; i < m_classes.size(); ++i) {
+    double count_i = m_classes.count(i);
+    // pairs within the class
+    expected_edges += count_i * (count_i - 1) / 2 *
+                      probability(scale * m_avg_heavy[i] * m_avg_sigma[i]);
+    // pairs with the lighter classes
+    for (unsigned j = i + 1; j < m_classes.size(); ++j) {
+      expected_edges += count_i * m_classes.count(j) *
+                        probability(scale * m_avg_heavy[i] * m_avg_sigma[j]);
+    }
+  }
+  return expected_edges;
+}
+
+ChungLuEdgeEstimator::ChungLuEdgeEstimator(const std::vector<double>& weights,
+                                           const SigmaWeights& powers,
+                                           double max_ratio)
+    : m_classes(weights, max_ratio),
+      m_avg_heavy(m_classes.sums(powers.heavy)),
+      m_avg_light(m_classes.sums(powers.light)),
+      m_light_prefix(prefix_sums(m_avg_light)),
+      m_weight_sum(sum(weights)) {
+  for (unsigned c = 0; c < m_classes.size(); ++c) {
+    m_avg_heavy[c] /= m_classes.count(c);
+    m_avg_light[c] /= m_classes.count(c);
+  }
+}
+
+ChungLuEdgeEstimator::ChungLuEdgeEstimator(const std::vector<double>& weights,
+                                           double ple, double sigma,
+                                           double max_ratio)
+    : m_classes(weights, max_ratio),
+      m_avg_heavy(m_classes.power_sums(weights, std::min(1.0, ple - sigma))),
+      m_avg_light(m_classes.power_sums(weights, sigma)),
+      m_light_prefix(prefix_sums(m_avg_light)),
+      m_weight_sum(sum(weights)) {
+  for (unsigned c = 0; c < m_classes.size(); ++c) {
+    m_avg_heavy[c] /= m_classes.count(c);
+    m_avg_light[c] /= m_classes.count(c);
+  }
+}
+
+double ChungLuEdgeEstimator::operator()(double factor) const {
+  unsigned nr_classes = m_classes.size();
+  double expected_edges = 0.0;
+  // The pairs of class c with the classes c + 1, ..., capped_end - 1
+  // have probability 1.  For lighter classes, the probability is
+  // linear in the factor and the sum over all their vertices is thus
+  // given by the prefix sums.  From one class to the next heavier
+  // one, capped_end only grows (once the capped classes are
+  // non-empty, they start directly after the class).
+  unsigned capped_end = nr_classes + 1;
+  for (unsigned c = nr_classes; c-- > 0;) {
+    double x = factor * m_avg_heavy[c] / m_weight_sum;
+    double count = m_classes.count(c);
+
+    // pairs within the class
+    expected_edges +=
+        count * (count - 1) / 2 * std::min(1.0, x * m_avg_light[c]);
+
+    // pairs with the lighter classes
+    if (capped_end == c + 2) capped_end = c + 1;
+    while (capped_end < nr_classes && x * m_avg_light[capped_end] >= 1.0) {
+      capped_end++;
+    }
+    double nr_capped = m_classes.begin(capped_end) - m_classes.end(c);
+    double light_uncapped =
+        m_light_prefix[nr_classes] - m_light_prefix[capped_end];
+    expected_edges += count * (nr_capped + x * light_uncapped);
+  }
+  return expected_edges;
+}
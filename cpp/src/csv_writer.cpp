@@ -0,0 +1,36 @@
+#include "csv_writer.hpp"
+
+#include <cstring>
+
+CsvWriter::CsvWriter(std::ostream& out, char separator)
+    : m_out(out), m_separator(separator), m_buffer(1 << 20) {}
+
+CsvWriter::~CsvWriter() { flush(); }
+
+void CsvWriter::write(bool x) { put(x ? '1' : '0'); }
+
+void CsvWriter::write(double x) {
+  reserve(max_number_length);
+  m_size = std::to_chars(end(), end() + max_number_length, x).ptr -
+           m_buffer.data();
+}
+
+void CsvWriter::write(char c) { put(c); }
+
+void CsvWriter::write(const char* s) { write(std::string_view(s)); }
+
+void CsvWriter::write(std::string_view s) {
+  if (s.size() > m_buffer.size()) {
+    flush();
+    m_out.write(s.data(), s.size());
+    return;
+  }
+  reserve(s.size());
+  std::memcpy(end(), s.data(), s.size());
+  m_size += s.size();
+}
+
+void CsvWriter::flush() {
+  m_out.write(m_buffer.data(), m_size);
+  m_size = 0;
+}
@@ -1,11 +1,25 @@
 #include "edge_list.hpp"
 
 #include <sstream>
+#include <utility>
 
+#include "binary_edges.hpp"
 #include "types.hpp"
 
-EdgeList::EdgeList(std::istream& input)
+EdgeList::EdgeList(std::istream& input, bool with_neighbors)
     : m_deg(3), m_neighbors(3), m_graph_type(UNDIRECTED) {
+  m_with_neighbors = with_neighbors;
+  if (is_binary_edges(input)) {
+    BinaryEdgeReader reader(input);
+    m_graph_type = reader.type();
+    Edge e;
+    while (reader.next(e)) {
+      m_edges.push_back(e);
+      add_edge(e.s, e.t);
+    }
+    return;
+  }
+
   std::string line;
   unsigned offset = 0;
   // check whether it starts with a comment specifying the graph type
@@ -32,17 +46,34 @@ EdgeList::EdgeList(std::istream& input)
     line_ss >> t;
     s -= offset;
     t -= offset;
-    deg_mut(OUT, s)++;
-    deg_mut(IN, t)++;
-    deg_mut(SUM, s)++;
-    deg_mut(SUM, t)++;
     m_edges.push_back({s, t});
-    neighbors(OUT, s).push_back(t);
-    neighbors(IN, t).push_back(s);
-    if (m_graph_type != BIPARTITE) {
-      neighbors(SUM, s).push_back(t);
-      neighbors(SUM, t).push_back(s);
-    }
+    add_edge(s, t);
+  }
+}
+
+EdgeList::EdgeList(std::vector<Edge> edges, GraphType type,
+                   bool with_neighbors)
+    : m_graph_type(type),
+      m_edges(std::move(edges)),
+      m_deg(3),
+      m_neighbors(3),
+      m_with_neighbors(with_neighbors) {
+  for (const Edge& e : m_edges) {
+    add_edge(e.s, e.t);
+  }
+}
+
+void EdgeList::add_edge(Node s, Node t) {
+  deg_mut(OUT, s)++;
+  deg_mut(IN, t)++;
+  deg_mut(SUM, s)++;
+  deg_mut(SUM, t)++;
+  if (!m_with_neighbors) return;
+  neighbors(OUT, s).push_back(t);
+  neighbors(IN, t).push_back(s);
+  if (m_graph_type != BIPARTITE) {
+    neighbors(SUM, s).push_back(t);
+    neighbors(SUM, t).push_back(s);
   }
 }
 
@@ -83,13 +114,17 @@ std::vector<Point> EdgeList::degree_points(
     DegType sdeg, DegType tdeg, bool undirected_both_orientations) const {
   check_configuration(sdeg, tdeg);
 
-  std::vector<Point> res;
-  for (const Edge& e : m_edges) {
+  bool both = m_graph_type == UNDIRECTED && undirected_both_orientations;
+  std::vector<Point> res(both ? 2 * m_edges.size() : m_edges.size());
+#pragma omp parallel for
+  for (std::size_t i = 0; i < m_edges.size(); ++i) {
+    const Edge& e = m_edges[i];
     Point p{deg(sdeg, e.s), deg(tdeg, e.t)};
-    res.push_back(p);
-    if (m_graph_type == UNDIRECTED && undirected_both_orientations) {
-      Point q = {p.y, p.x};
-      res.push_back(q);
+    if (both) {
+      res[2 * i] = p;
+      res[2 * i + 1] = {p.y, p.x};
+    } else {
+      res[i] = p;
     }
   }
   return res;
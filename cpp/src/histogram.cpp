@@ -1,8 +1,10 @@
 #include "histogram.hpp"
 
+#include <omp.h>
+
 #include <algorithm>
 #include <cmath>
-#include <functional>
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
@@ -10,6 +12,34 @@
 
 Histogram::Histogram() : m_max(0), m_frequency_by_measurement(1, 0) {}
 
+Histogram::Histogram(const std::vector<unsigned>& measurements) : m_max(0) {
+  unsigned max = 0;
+#pragma omp parallel for reduction(max : max)
+  for (std::size_t i = 0; i < measurements.size(); ++i) {
+    max = std::max(max, measurements[i]);
+  }
+  m_max = max;
+  m_frequency_by_measurement.assign(std::size_t(m_max) + 1, 0);
+
+  std::vector<std::vector<std::uint64_t>> local(omp_get_max_threads());
+#pragma omp parallel
+  {
+    auto& frequency = local[omp_get_thread_num()];
+    frequency.assign(std::size_t(m_max) + 1, 0);
+#pragma omp for
+    for (std::size_t i = 0; i < measurements.size(); ++i) {
+      frequency[measurements[i]]++;
+    }
+  }
+
+#pragma omp parallel for
+  for (std::size_t m = 0; m <= m_max; ++m) {
+    for (const auto& frequency : local) {
+      if (!frequency.empty()) m_frequency_by_measurement[m] += frequency[m];
+    }
+  }
+}
+
 void Histogram::add(unsigned measurement) {
   if (measurement > m_max) {
     m_max = measurement;
@@ -20,7 +50,7 @@ void Histogram::add(unsigned measurement) {
 
 unsigned Histogram::maximum() const { return m_max; }
 
-unsigned Histogram::frequency(unsigned measurement) const {
+std::uint64_t Histogram::frequency(unsigned measurement) const {
   return measurement > m_max ? 0 : m_frequency_by_measurement[measurement];
 }
 
@@ -37,30 +67,178 @@ std::vector<double> log_breaks(double min, double max, unsigned nr_buckets) {
   return breaks;
 }
 
-Histogram2D::Histogram2D(const std::vector<Point>& points, unsigned nr_buckets,
-                         bool complementary_cumulative) {
-  // creating the breaks
-  unsigned max_x =
-      std::max_element(points.begin(), points.end(), [](auto& p1, auto& p2) {
-        return p1.x < p2.x;
-      })->x;
+namespace {
 
-  unsigned max_y =
-      std::max_element(points.begin(), points.end(), [](auto& p1, auto& p2) {
-        return p1.y < p2.y;
-      })->y;
+// lookup table: the bucket of each value up to max (the last break
+// that is not larger than the value)
+std::vector<unsigned> bucket_table(const std::vector<double>& breaks,
+                                   unsigned max) {
+  std::vector<unsigned> bucket(max + 1);
+  for (unsigned val = 0; val <= max; ++val) {
+    auto ub = std::upper_bound(breaks.begin(), breaks.end(), val);
+    bucket[val] = std::distance(breaks.begin(), ub) - 1;
+  }
+  return bucket;
+}
 
-  m_breaks_x = log_breaks(1, max_x + 1, nr_buckets);
-  m_breaks_y = log_breaks(1, max_y + 1, nr_buckets);
-  
-  // precompute bucket centers
-  m_bucket_center_x.resize(nr_buckets);
-  m_bucket_center_y.resize(nr_buckets);
-  for (unsigned bucket = 0; bucket < nr_buckets; ++bucket) {
-    m_bucket_center_x[bucket] = std::sqrt(lb_x(bucket) * ub_x(bucket));
-    m_bucket_center_y[bucket] = std::sqrt(lb_y(bucket) * ub_y(bucket));
+}  // namespace
+
+namespace {
+
+// concatenation of the parts (copied in parallel)
+std::vector<PointCount> concatenate(
+    const std::vector<std::vector<PointCount>>& parts) {
+  std::vector<std::size_t> offset(parts.size() + 1, 0);
+  for (std::size_t i = 0; i < parts.size(); ++i) {
+    offset[i + 1] = offset[i] + parts[i].size();
+  }
+  std::vector<PointCount> result(offset.back());
+#pragma omp parallel for schedule(dynamic, 64)
+  for (std::size_t i = 0; i < parts.size(); ++i) {
+    std::copy(parts[i].begin(), parts[i].end(), result.begin() + offset[i]);
+  }
+  return result;
+}
+
+// Counting with one dense table of counters per thread.  The tables
+// are added up row by row in parallel.
+std::vector<PointCount> count_points_dense(const std::vector<Point>& points,
+                                           unsigned max_x, unsigned max_y) {
+  std::size_t width = std::size_t(max_y) + 1;
+  std::size_t nr_cells = (std::size_t(max_x) + 1) * width;
+  std::vector<std::vector<std::uint64_t>> tables(omp_get_max_threads());
+#pragma omp parallel
+  {
+    auto& table = tables[omp_get_thread_num()];
+    table.assign(nr_cells, 0);
+#pragma omp for
+    for (std::size_t i = 0; i < points.size(); ++i) {
+      table[points[i].x * width + points[i].y]++;
+    }
+  }
+
+  std::vector<std::vector<PointCount>> rows(std::size_t(max_x) + 1);
+#pragma omp parallel for schedule(dynamic, 64)
+  for (unsigned x = 0; x <= max_x; ++x) {
+    for (unsigned y = 0; y <= max_y; ++y) {
+      std::uint64_t count = 0;
+      for (const auto& table : tables) {
+        if (!table.empty()) count += table[x * width + y];
+      }
+      if (count > 0) rows[x].push_back({{x, y}, count});
+    }
+  }
+  return concatenate(rows);
+}
+
+// Counting for large ranges of values: the points are partitioned
+// into ranges of x-values with roughly the same number of points (one
+// radix pass).  Then, each partition is sorted and counted on its own.
+std::vector<PointCount> count_points_partitioned(
+    const std::vector<Point>& points, unsigned max_x) {
+  std::size_t nr_chunks = omp_get_max_threads();
+  auto chunk_begin = [&](std::size_t chunk) {
+    return chunk * points.size() / nr_chunks;
+  };
+
+  // number of points for each x-value
+  std::vector<std::vector<std::uint64_t>> x_counts(nr_chunks);
+#pragma omp parallel for
+  for (std::size_t chunk = 0; chunk < nr_chunks; ++chunk) {
+    x_counts[chunk].assign(std::size_t(max_x) + 1, 0);
+    for (std::size_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); ++i) {
+      x_counts[chunk][points[i].x]++;
+    }
   }
 
+  // partition of each x-value
+  std::size_t nr_partitions = 8 * nr_chunks;
+  std::size_t partition_size = points.size() / nr_partitions + 1;
+  std::vector<unsigned> partition_of(std::size_t(max_x) + 1);
+  std::uint64_t so_far = 0;
+  for (unsigned x = 0; x <= max_x; ++x) {
+    partition_of[x] = std::min(nr_partitions - 1, so_far / partition_size);
+    for (const auto& counts : x_counts) so_far += counts[x];
+  }
+
+  // scatter the points (as 64-bit keys) to their partitions; each
+  // chunk writes to its own range within each partition
+  std::vector<std::vector<std::size_t>> offset(
+      nr_chunks, std::vector<std::size_t>(nr_partitions, 0));
+#pragma omp parallel for
+  for (std::size_t chunk = 0; chunk < nr_chunks; ++chunk) {
+    for (std::size_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); ++i) {
+      offset[chunk][partition_of[points[i].x]]++;
+    }
+  }
+  std::vector<std::size_t> partition_begin(nr_partitions + 1, 0);
+  std::size_t running = 0;
+  for (std::size_t p = 0; p < nr_partitions; ++p) {
+    partition_begin[p] = running;
+    for (std::size_t chunk = 0; chunk < nr_chunks; ++chunk) {
+      std::size_t count = offset[chunk][p];
+      offset[chunk][p] = running;
+      running += count;
+    }
+  }
+  partition_begin[nr_partitions] = running;
+
+  std::vector<std::uint64_t> keys(points.size());
+#pragma omp parallel for
+  for (std::size_t chunk = 0; chunk < nr_chunks; ++chunk) {
+    for (std::size_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); ++i) {
+      const Point& p = points[i];
+      keys[offset[chunk][partition_of[p.x]]++] =
+          (std::uint64_t(p.x) << 32) | p.y;
+    }
+  }
+
+  // sort each partition and count the runs of equal points
+  std::vector<std::vector<PointCount>> parts(nr_partitions);
+#pragma omp parallel for schedule(dynamic)
+  for (std::size_t p = 0; p < nr_partitions; ++p) {
+    auto begin = keys.begin() + partition_begin[p];
+    auto end = keys.begin() + partition_begin[p + 1];
+    std::sort(begin, end);
+    for (auto it = begin; it != end; ++it) {
+      if (it == begin || *it != *(it - 1)) {
+        parts[p].push_back({{unsigned(*it >> 32), unsigned(*it)}, 0});
+      }
+      parts[p].back().count++;
+    }
+  }
+  return concatenate(parts);
+}
+
+}  // namespace
+
+std::vector<PointCount> count_points(const std::vector<Point>& points,
+                                     std::size_t max_dense_counters) {
+  unsigned max_x = 0, max_y = 0;
+#pragma omp parallel for reduction(max : max_x, max_y)
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    max_x = std::max(max_x, points[i].x);
+    max_y = std::max(max_y, points[i].y);
+  }
+  double nr_counters = (max_x + 1.0) * (max_y + 1.0) * omp_get_max_threads();
+  if (nr_counters <= max_dense_counters) {
+    return count_points_dense(points, max_x, max_y);
+  }
+  return count_points_partitioned(points, max_x);
+}
+
+template <typename PointOf, typename WeightOf>
+void Histogram2D::fill(std::size_t nr_points, PointOf point, WeightOf weight,
+                       unsigned nr_buckets) {
+  // creating the breaks
+  unsigned max_x = 0, max_y = 0;
+#pragma omp parallel for reduction(max : max_x, max_y)
+  for (std::size_t i = 0; i < nr_points; ++i) {
+    max_x = std::max(max_x, point(i).x);
+    max_y = std::max(max_y, point(i).y);
+  }
+  init_buckets(max_x, max_y, nr_buckets);
+
   // std::cout << "max: " << max_x << " " << max_y << std::endl;
   // std::cout << "breaks x" << std::endl;
   // for (auto b : m_breaks_x) {
@@ -71,21 +249,23 @@ Histogram2D::Histogram2D(const std::vector<Point>& points, unsigned nr_buckets,
   //   std::cout << b << "\n";
   // }
 
-  // assigning each point to the correct cell
-  m_histogram.resize(nr_buckets);
-  for (auto& col : m_histogram) {
-    col.resize(nr_buckets, 0);
-  }
-
-  auto index = [](std::vector<double> vec, unsigned val) {
-    auto ub = std::upper_bound(vec.begin(), vec.end(), val);
-    return std::distance(vec.begin(), ub) - 1;
-  };
+  auto bucket_x = bucket_table(m_breaks_x, max_x);
+  auto bucket_y = bucket_table(m_breaks_y, max_y);
 
-  for (const auto& p : points) {
-    unsigned cell_x = index(m_breaks_x, p.x);
-    unsigned cell_y = index(m_breaks_y, p.y);
-    m_histogram[cell_x][cell_y]++;
+  // assigning each point to the correct cell: each thread counts its
+  // points in a local histogram; these are added up afterwards
+#pragma omp parallel
+  {
+    std::vector<std::uint64_t> local(nr_buckets * nr_buckets, 0);
+#pragma omp for nowait
+    for (std::size_t i = 0; i < nr_points; ++i) {
+      Point p = point(i);
+      local[bucket_x[p.x] * nr_buckets + bucket_y[p.y]] += weight(i);
+    }
+#pragma omp critical
+    for (std::size_t cell = 0; cell < m_histogram.size(); ++cell) {
+      m_histogram[cell] += local[cell];
+    }
   }
 
   // auto print_histogram = [&]() {
@@ -97,33 +277,62 @@ Histogram2D::Histogram2D(const std::vector<Point>& points, unsigned nr_buckets,
   //   for (int y = nr_buckets - 1; y >= 0; --y) {
   //     std::cout << m_breaks_y[y] << ":\t";
   //     for (unsigned x = 0; x < nr_buckets; ++x) {
-  //       std::cout << m_histogram[x][y] << "\t";
+  //       std::cout << count(x, y) << "\t";
   //     }
   //     std::cout << "\n";
   //   }
   // };
 
   // print_histogram();
+}
 
-  if (!complementary_cumulative) return;
+Histogram2D::Histogram2D(const std::vector<Point>& points, unsigned nr_buckets,
+                         bool complementary_cumulative) {
+  fill(
+      points.size(), [&](std::size_t i) { return points[i]; },
+      [](std::size_t) { return std::uint64_t(1); }, nr_buckets);
+  if (complementary_cumulative) make_complementary_cumulative();
+}
 
-  // making it cumulative
-  std::vector<std::vector<bool>> done(nr_buckets,
-                                      std::vector<bool>(nr_buckets, false));
+Histogram2D::Histogram2D(const std::vector<PointCount>& point_counts,
+                         unsigned nr_buckets, bool complementary_cumulative) {
+  fill(
+      point_counts.size(), [&](std::size_t i) { return point_counts[i].point; },
+      [&](std::size_t i) { return point_counts[i].count; }, nr_buckets);
+  if (complementary_cumulative) make_complementary_cumulative();
+}
 
-  std::function<unsigned(unsigned, unsigned)> cum_val_rec =
-      [&](unsigned x, unsigned y) -> unsigned {
-    if (x >= nr_buckets || y >= nr_buckets) {
-      return 0;
-    } else if (!done[x][y]) {
-      m_histogram[x][y] += cum_val_rec(x + 1, y) + cum_val_rec(x, y + 1) -
-                           cum_val_rec(x + 1, y + 1);
-      done[x][y] = true;
-    }
-    return m_histogram[x][y];
-  };
+void Histogram2D::init_buckets(unsigned max_x, unsigned max_y,
+                               unsigned nr_buckets) {
+  m_breaks_x = log_breaks(1, max_x + 1, nr_buckets);
+  m_breaks_y = log_breaks(1, max_y + 1, nr_buckets);
 
-  cum_val_rec(0, 0);
+  // precompute bucket centers
+  m_bucket_center_x.resize(nr_buckets);
+  m_bucket_center_y.resize(nr_buckets);
+  for (unsigned bucket = 0; bucket < nr_buckets; ++bucket) {
+    m_bucket_center_x[bucket] = std::sqrt(lb_x(bucket) * ub_x(bucket));
+    m_bucket_center_y[bucket] = std::sqrt(lb_y(bucket) * ub_y(bucket));
+  }
+
+  m_nr_buckets = nr_buckets;
+  m_histogram.assign(nr_buckets * nr_buckets, 0);
+}
+
+void Histogram2D::make_complementary_cumulative() {
+  // cell (x, y) becomes the sum over all cells (x', y') with x' >= x
+  // and y' >= y: suffix sums within each row, then across the rows
+  unsigned nr = m_nr_buckets;
+  if (nr == 0) return;
+  for (unsigned x = 0; x < nr; ++x) {
+    std::uint64_t* row = &m_histogram[x * nr];
+    for (unsigned y = nr - 1; y-- > 0;) row[y] += row[y + 1];
+  }
+  for (unsigned x = nr - 1; x-- > 0;) {
+    std::uint64_t* row = &m_histogram[x * nr];
+    const std::uint64_t* next_row = &m_histogram[(x + 1) * nr];
+    for (unsigned y = 0; y < nr; ++y) row[y] += next_row[y];
+  }
   // std::cout << std::endl;
   // print_histogram();
 }
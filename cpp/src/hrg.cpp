@@ -0,0 +1,364 @@
+#include "hrg.hpp"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+
+#include "calibration.hpp"
+
+namespace {
+
+constexpr double pi = std::numbers::pi;
+
+// The points of one radial band [min_radius, max_radius), sorted by
+// angle.  The bucket index allows to find the first point with at
+// least a given angle in expected constant time.
+struct Band {
+  Band(double min_radius, double max_radius)
+      : min_radius(min_radius), max_radius(max_radius) {}
+
+  double min_radius;
+  double max_radius;
+  std::vector<Node> vertices;
+  std::vector<double> angle;
+  std::vector<double> radius;
+  std::vector<double> sinh_radius;
+  // bucket k contains the points with angle in [2πk / b, 2π(k + 1) / b)
+  std::vector<std::size_t> bucket_begin;
+
+  std::size_t size() const { return vertices.size(); }
+
+  void sort(const HyperbolicPoints& points) {
+    std::sort(vertices.begin(), vertices.end(), [&](Node u, Node v) {
+      return points.angle[u] < points.angle[v];
+    });
+    for (Node v : vertices) {
+      angle.push_back(points.angle[v]);
+      radius.push_back(points.radius[v]);
+      sinh_radius.push_back(std::sinh(points.radius[v]));
+    }
+    std::size_t nr_buckets = std::max<std::size_t>(1, size());
+    bucket_begin.assign(nr_buckets + 1, size());
+    for (std::size_t i = size(); i-- > 0;) {
+      bucket_begin[bucket(angle[i])] = i;
+    }
+    for (std::size_t k = nr_buckets; k-- > 0;) {
+      bucket_begin[k] = std::min(bucket_begin[k], bucket_begin[k + 1]);
+    }
+  }
+
+  std::size_t bucket(double phi) const {
+    std::size_t nr_buckets = bucket_begin.size() - 1;
+    return std::min(nr_buckets - 1, std::size_t(phi / (2 * pi) * nr_buckets));
+  }
+
+  // index of the first point with angle >= phi (size() if none)
+  std::size_t first_from(double phi) const {
+    std::size_t i = bucket_begin[bucket(phi)];
+    while (i < size() && angle[i] < phi) ++i;
+    return i;
+  }
+};
+
+// Lower bound for the distance between a point with radius r (with
+// sinh_r = sinh(r)) and a point with radius at least min_radius at
+// angular distance phi (in [0, π]), as cosh of the distance.
+double min_cosh_dist(double sinh_r, double min_radius, double phi) {
+  double sin_half = std::sin(phi / 2);
+  return 1 + 2 * sinh_r * std::sinh(min_radius) * sin_half * sin_half;
+}
+
+class NeighborSampler {
+ public:
+  NeighborSampler(const HyperbolicPoints& points,
+                  const std::vector<Band>& bands, double R, double T,
+                  std::uint64_t seed)
+      : m_points(points),
+        m_bands(bands),
+        m_R(R),
+        m_T(T),
+        m_cosh_R(std::cosh(R)),
+        m_rng(seed) {}
+
+  // neighbors of the i-th point of band b in band b and outer bands
+  void sample(unsigned b, std::size_t i) {
+    Node u = m_bands[b].vertices[i];
+    for (unsigned c = b; c < m_bands.size(); ++c) {
+      if (m_bands[c].size() == 0) continue;
+      if (m_T == 0) {
+        threshold(u, m_bands[c], c == b);
+      } else {
+        temperature(u, m_bands[c], c == b);
+      }
+    }
+  }
+
+  std::vector<Edge>& edges() { return m_edges; }
+
+ private:
+  // Walk through the points of the band in the order of increasing
+  // angular distance to u: first forward (counterclockwise) through
+  // the points with offset in [0, π), then backward through the points
+  // with offset in [π, 2π).  For each step (of the given length),
+  // visit is called with the index of the point and its angular
+  // distance to u; the walk stops when visit returns false.
+  template <typename Step, typename Visit>
+  void walk(Node u, const Band& band, Step step, Visit visit) {
+    double phi_u = m_points.angle[u];
+    std::size_t start = band.first_from(phi_u);
+    std::size_t n = band.size();
+
+    for (std::size_t k = step(0.0); k < n; k += 1 + step(0.0)) {
+      std::size_t i = (start + k) % n;
+      double offset = band.angle[i] - phi_u;
+      if (offset < 0) offset += 2 * pi;
+      if (offset >= pi || !visit(i, offset)) break;
+    }
+    for (std::size_t k = step(pi); k < n; k += 1 + step(pi)) {
+      std::size_t i = (start + n - 1 - k) % n;
+      double offset = band.angle[i] - phi_u;
+      if (offset < 0) offset += 2 * pi;
+      if (offset < pi || !visit(i, 2 * pi - offset)) break;
+    }
+  }
+
+  void add_edge(Node u, Node v, bool same_band) {
+    // in the same band, each pair is found twice
+    if (same_band && u >= v) return;
+    m_edges.push_back({std::min(u, v), std::max(u, v)});
+  }
+
+  // T = 0: check all points in the angular range that can contain
+  // neighbors
+  void threshold(Node u, const Band& band, bool same_band) {
+    double r_u = m_points.radius[u];
+    double sinh_u = std::sinh(r_u);
+    // maximum angular distance: min_cosh_dist(phi) <= cosh(R)
+    double y = (m_cosh_R - 1) / (2 * sinh_u * std::sinh(band.min_radius));
+    double max_phi =
+        y >= 1 || !std::isfinite(y) ? pi : 2 * std::asin(std::sqrt(y));
+
+    walk(
+        u, band, [](double) { return 0; },
+        [&](std::size_t i, double phi) {
+          if (phi > max_phi) return false;
+          double sin_half = std::sin(phi / 2);
+          double cosh_dist = std::cosh(r_u - band.radius[i]) +
+                             2 * sinh_u * band.sinh_radius[i] * sin_half *
+                                 sin_half;
+          if (cosh_dist <= m_cosh_R) add_edge(u, band.vertices[i], same_band);
+          return true;
+        });
+  }
+
+  // T > 0: jump to the next candidate using the upper bound on the
+  // connection probability for the current angular distance, which
+  // is also a bound for all points further away
+  void temperature(Node u, const Band& band, bool same_band) {
+    double r_u = m_points.radius[u];
+    double sinh_u = std::sinh(r_u);
+    double max_p = 1.0;
+    auto bound = [&](double phi) {
+      double d = std::acosh(min_cosh_dist(sinh_u, band.min_radius, phi));
+      return hrg_probability(d, m_R, m_T);
+    };
+
+    // the bound for the start of each direction is at angle 0
+    auto step = [&](double) -> std::size_t {
+      if (max_p >= 1.0) return 0;
+      double skip = std::floor(std::log1p(-m_rng.uniform()) /
+                               std::log1p(-max_p));
+      return skip >= double(band.size()) ? band.size() : std::size_t(skip);
+    };
+
+    max_p = bound(0.0);
+    bool forward = true;
+    walk(
+        u, band,
+        [&](double direction) {
+          // reset the bound when switching to the backward direction
+          if (forward && direction == pi) {
+            forward = false;
+            max_p = bound(0.0);
+          }
+          return step(direction);
+        },
+        [&](std::size_t i, double phi) {
+          double d = hyperbolic_distance(r_u, m_points.angle[u],
+                                         band.radius[i], band.angle[i]);
+          if (m_rng.coin_flip(hrg_probability(d, m_R, m_T) / max_p)) {
+            add_edge(u, band.vertices[i], same_band);
+          }
+          max_p = bound(phi);
+          return max_p > 0.0;
+        });
+  }
+
+  const HyperbolicPoints& m_points;
+  const std::vector<Band>& m_bands;
+  double m_R;
+  double m_T;
+  double m_cosh_R;
+  RandomStream m_rng;
+  std::vector<Edge> m_edges;
+};
+
+}  // namespace
+
+HyperbolicPoints hrg_points(unsigned n, double R, double ple,
+                            std::uint64_t seed) {
+  double alpha = (ple - 1) / 2;
+  HyperbolicPoints points{std::vector<double>(n), std::vector<double>(n)};
+
+  // inverse transform sampling of the radii, in parallel chunks with
+  // independent random streams
+  const unsigned chunk_size = 1 << 16;
+  unsigned nr_chunks = (n + chunk_size - 1) / chunk_size;
+#pragma omp parallel for schedule(dynamic)
+  for (unsigned chunk = 0; chunk < nr_chunks; ++chunk) {
+    RandomStream rng(substream_seed(seed, chunk));
+    unsigned end = std::min(n, (chunk + 1) * chunk_size);
+    for (unsigned v = chunk * chunk_size; v < end; ++v) {
+      points.angle[v] = 2 * pi * rng.uniform();
+      points.radius[v] =
+          std::acosh(1 + rng.uniform() * (std::cosh(alpha * R) - 1)) / alpha;
+    }
+  }
+  return points;
+}
+
+std::vector<Edge> hrg_edges(const HyperbolicPoints& points, double R,
+                            double T, std::uint64_t seed) {
+  unsigned n = points.radius.size();
+
+  // bands [0, R / 2), [R / 2, R / 2 + 1), ...
+  std::vector<Band> bands = {Band(0.0, R / 2)};
+  while (bands.back().max_radius < R) {
+    double min_radius = bands.back().max_radius;
+    bands.emplace_back(min_radius, std::min(R, min_radius + 1));
+  }
+  auto band_of = [&](double r) {
+    if (r < R / 2) return std::size_t(0);
+    return std::min(bands.size() - 1, std::size_t(r - R / 2) + 1);
+  };
+  for (Node v = 0; v < n; ++v) {
+    bands[band_of(points.radius[v])].vertices.push_back(v);
+  }
+#pragma omp parallel for schedule(dynamic)
+  for (unsigned b = 0; b < bands.size(); ++b) {
+    bands[b].sort(points);
+  }
+
+  // the points (by band) are processed in chunks in parallel, each
+  // with its own random stream
+  const std::size_t chunk_size = 1 << 14;
+  std::vector<std::pair<unsigned, std::size_t>> chunks;
+  for (unsigned b = 0; b < bands.size(); ++b) {
+    for (std::size_t i = 0; i < bands[b].size(); i += chunk_size) {
+      chunks.push_back({b, i});
+    }
+  }
+  std::vector<std::vector<Edge>> edges_by_chunk(chunks.size());
+#pragma omp parallel for schedule(dynamic)
+  for (std::size_t c = 0; c < chunks.size(); ++c) {
+    auto [b, begin] = chunks[c];
+    NeighborSampler sampler(points, bands, R, T, substream_seed(seed, c));
+    std::size_t end = std::min(bands[b].size(), begin + chunk_size);
+    for (std::size_t i = begin; i < end; ++i) {
+      sampler.sample(b, i);
+    }
+    edges_by_chunk[c] = std::move(sampler.edges());
+  }
+
+  std::vector<Edge> edges;
+  for (auto& chunk_edges : edges_by_chunk) {
+    edges.insert(edges.end(), chunk_edges.begin(), chunk_edges.end());
+    chunk_edges = {};
+  }
+
+  // canonical order of the edges
+  sort_edges(edges);
+  return edges;
+}
+
+double hrg_expected_degree(unsigned n, double R, double ple, double T) {
+  double alpha = (ple - 1) / 2;
+
+  // radial density on a grid (midpoint rule), normalized to 1
+  const unsigned nr_radii = 100;
+  double h = R / nr_radii;
+  std::vector<double> r(nr_radii), w(nr_radii), sinh_r(nr_radii);
+  for (unsigned i = 0; i < nr_radii; ++i) {
+    r[i] = (i + 0.5) * h;
+    w[i] = std::sinh(alpha * r[i]);
+    sinh_r[i] = std::sinh(r[i]);
+  }
+  double sum = std::accumulate(w.begin(), w.end(), 0.0);
+  for (double& x : w) x /= sum;
+
+  // probability that two points with radii r1 and r2 are connected
+  // (averaged over the angle)
+  double cosh_R = std::cosh(R);
+  auto probability = [&](unsigned i, unsigned j) {
+    double cosh_diff = std::cosh(r[i] - r[j]);
+    double two_sinh = 2 * sinh_r[i] * sinh_r[j];
+    if (T == 0) {
+      // connected if the angle is at most θ with
+      // sin²(θ / 2) = (cosh(R) - cosh(r1 - r2)) / (2 sinh(r1) sinh(r2))
+      double y = (cosh_R - cosh_diff) / two_sinh;
+      if (y <= 0) return 0.0;
+      if (y >= 1) return 1.0;
+      return 2 * std::asin(std::sqrt(y)) / pi;
+    }
+    // integrate over the angle φ = π e^{-s}, as the probability
+    // changes on the scale of e^{(R - r1 - r2) / 2}
+    double ds = std::min(0.1, T / 2);
+    double max_s = R / 2 + 20;
+    auto p = [&](double phi) {
+      double sin_half = std::sin(phi / 2);
+      double d = std::acosh(cosh_diff + two_sinh * sin_half * sin_half);
+      return hrg_probability(d, R, T);
+    };
+    double res = pi * std::exp(-max_s) * p(pi * std::exp(-max_s));
+    for (double s = ds / 2; s < max_s; s += ds) {
+      double phi = pi * std::exp(-s);
+      res += p(phi) * phi * ds;
+    }
+    return res / pi;
+  };
+
+  // the rows are summed in a fixed order, such that the result (and
+  // thus the radius) does not depend on the number of threads
+  std::vector<double> rows(nr_radii, 0.0);
+#pragma omp parallel for schedule(dynamic)
+  for (unsigned i = 0; i < nr_radii; ++i) {
+    for (unsigned j = i; j < nr_radii; ++j) {
+      rows[i] += (i == j ? 1 : 2) * w[i] * w[j] * probability(i, j);
+    }
+  }
+  return (n - 1) * std::accumulate(rows.begin(), rows.end(), 0.0);
+}
+
+double hrg_radius(unsigned n, double deg, double ple, double T) {
+  // The expected degree is roughly proportional to n e^{-R / 2} ->
+  // find x = e^{-R / 2} (the expected degree is increasing in x),
+  // starting with the asymptotic estimate.
+  double alpha = (ple - 1) / 2;
+  double xi = alpha / (alpha - 0.5);
+  double factor = T == 0 ? 1.0 : pi * T / std::sin(pi * T);
+  double x0 = deg / (2 / pi * xi * xi * n * factor);
+  auto expected_degree = [&](double x) {
+    return hrg_expected_degree(n, -2 * std::log(x), ple, T);
+  };
+  return -2 * std::log(find_root(expected_degree, deg, x0));
+}
+
+HyperbolicGraph hrg(unsigned n, double deg, double ple, double T) {
+  double R = hrg_radius(n, deg, ple, T);
+  std::uint64_t seed = Random::natural_number();
+  auto points = hrg_points(n, R, ple, substream_seed(seed, 0));
+  return {R, hrg_edges(points, R, T, substream_seed(seed, 1))};
+}
@@ -1,6 +1,10 @@
 #include "random.hpp"
 
+#include <omp.h>
+
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <random>
 
 Random::Random()
@@ -35,3 +39,112 @@ unsigned Random::geometric_skip(double p) {
   std::geometric_distribution<int> distr(p);
   return distr(r.m_engine);
 }
+
+void for_each_seed(const std::vector<unsigned>& seeds,
+                   const std::function<void(std::size_t)>& f) {
+  int nr_threads = omp_get_max_threads();
+  int nr_outer = std::max(1, std::min(nr_threads, int(seeds.size())));
+  int nr_inner = std::max(1, nr_threads / nr_outer);
+  int max_levels = omp_get_max_active_levels();
+  if (nr_outer > 1) omp_set_max_active_levels(omp_get_level() + 2);
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nr_outer) \
+    if (nr_outer > 1)
+  for (std::size_t i = 0; i < seeds.size(); ++i) {
+    omp_set_num_threads(nr_inner);
+    Random::set_seed(seeds[i]);
+    f(i);
+  }
+  omp_set_max_active_levels(max_levels);
+}
+
+namespace {
+
+double log_factorial(std::uint64_t k) { return std::lgamma(k + 1.0); }
+
+// simulate the draws one by one (for small samples)
+std::uint64_t hypergeometric_simulation(std::uint64_t good, std::uint64_t bad,
+                                        std::uint64_t sample,
+                                        RandomStream& rng) {
+  std::uint64_t total = good + bad;
+  std::uint64_t computed_sample = std::min(sample, total - sample);
+  std::uint64_t remaining_total = total;
+  std::uint64_t remaining_good = good;
+  while (computed_sample > 0 && remaining_good > 0 &&
+         remaining_total > remaining_good) {
+    --remaining_total;
+    std::uniform_int_distribution<std::uint64_t> distr(0, remaining_total);
+    if (distr(rng) < remaining_good) --remaining_good;
+    --computed_sample;
+  }
+  // only good elements left
+  if (remaining_total == remaining_good) remaining_good -= computed_sample;
+
+  return sample > total - sample ? remaining_good : good - remaining_good;
+}
+
+// ratio of uniforms (Stadlober 1989, HRUA with the correction by
+// Ivan Frohne)
+std::uint64_t hypergeometric_hrua(std::uint64_t good, std::uint64_t bad,
+                                  std::uint64_t sample, RandomStream& rng) {
+  const double d1 = 1.7155277699214135;  // 2 sqrt(2 / e)
+  const double d2 = 0.8989161620588988;  // 3 - 2 sqrt(3 / e)
+
+  std::uint64_t total = good + bad;
+  std::uint64_t computed_sample = std::min(sample, total - sample);
+  std::uint64_t min_good_bad = std::min(good, bad);
+  std::uint64_t max_good_bad = std::max(good, bad);
+
+  double p = double(min_good_bad) / total;
+  double q = double(max_good_bad) / total;
+  double mu = computed_sample * p;
+  double a = mu + 0.5;
+  double var =
+      double(total - computed_sample) * computed_sample * p * q / (total - 1);
+  double c = std::sqrt(var + 0.5);
+  double h = d1 * c + d2;
+
+  auto mode = std::uint64_t(double(computed_sample + 1) * (min_good_bad + 1) /
+                            (total + 2));
+  auto log_weight = [&](std::uint64_t k) {
+    return log_factorial(k) + log_factorial(min_good_bad - k) +
+           log_factorial(computed_sample - k) +
+           log_factorial(max_good_bad - computed_sample + k);
+  };
+  double g = log_weight(mode);
+  double b = std::min(double(std::min(computed_sample, min_good_bad) + 1),
+                      std::floor(a + 16 * c));
+
+  std::uint64_t k;
+  while (true) {
+    double u = rng.uniform();
+    double v = rng.uniform();
+    if (u == 0.0) continue;
+    double x = a + h * (v - 0.5) / u;
+
+    // fast rejection
+    if (x < 0.0 || x >= b) continue;
+    k = std::uint64_t(x);
+    double t = g - log_weight(k);
+
+    // fast acceptance
+    if (u * (4.0 - u) - 3.0 <= t) break;
+    // fast rejection
+    if (u * (u - t) >= 1) continue;
+    // acceptance
+    if (2.0 * std::log(u) <= t) break;
+  }
+
+  if (good > bad) k = computed_sample - k;
+  if (computed_sample < sample) k = good - k;
+  return k;
+}
+
+}  // namespace
+
+std::uint64_t hypergeometric(std::uint64_t good, std::uint64_t bad,
+                             std::uint64_t sample, RandomStream& rng) {
+  if (sample >= 10 && sample + 10 <= good + bad) {
+    return hypergeometric_hrua(good, bad, sample, rng);
+  }
+  return hypergeometric_simulation(good, bad, sample, rng);
+}
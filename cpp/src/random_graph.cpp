@@ -3,125 +3,161 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <numeric>
-#include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include "calibration.hpp"
 #include "random.hpp"
+#include "weights.hpp"
+
+namespace {
+
+// The pairs u > v are numbered in lexicographic order, i.e., pair
+// (u, v) has index u (u - 1) / 2 + v.
+Edge pair_of_index(std::uint64_t k) {
+  // u is the largest integer with u (u - 1) / 2 <= k; the floating
+  // point estimate is off by at most one
+  auto u = std::uint64_t((1 + std::sqrt(1 + 8.0 * k)) / 2);
+  while (u * (u - 1) / 2 > k) u--;
+  while ((u + 1) * u / 2 <= k) u++;
+  return Edge{Node(u), Node(k - u * (u - 1) / 2)};
+}
+
+// Samples k of the numbers lo, ..., hi - 1 without replacement and
+// writes them in increasing order to out.  The range is split in the
+// middle, the number of samples in the left half is hypergeometrically
+// distributed, and both halves are sampled independently (in
+// parallel).  Small samples are drawn with Floyd's algorithm.  The
+// result only depends on the seed.
+void sample_sorted(std::uint64_t lo, std::uint64_t hi, std::uint64_t k,
+                   std::uint64_t seed, std::uint64_t* out) {
+  if (k == 0) return;
+  RandomStream rng(seed);
+
+  if (k <= 4096) {
+    std::uint64_t size = hi - lo;
+    std::unordered_set<std::uint64_t> sampled;
+    sampled.reserve(2 * k);
+    for (std::uint64_t j = size - k; j < size; ++j) {
+      std::uniform_int_distribution<std::uint64_t> distr(0, j);
+      std::uint64_t x = distr(rng);
+      sampled.insert(sampled.contains(x) ? j : x);
+    }
+    std::copy(sampled.begin(), sampled.end(), out);
+    std::sort(out, out + k);
+    for (std::uint64_t i = 0; i < k; ++i) out[i] += lo;
+    return;
+  }
+
+  std::uint64_t mid = lo + (hi - lo) / 2;
+  std::uint64_t k_left = hypergeometric(mid - lo, hi - mid, k, rng);
+#pragma omp task if (k > (1 << 16))
+  sample_sorted(lo, mid, k_left, substream_seed(seed, 0), out);
+  sample_sorted(mid, hi, k - k_left, substream_seed(seed, 1), out + k_left);
+#pragma omp taskwait
+}
+
+}  // namespace
 
 std::vector<Edge> gilbert(unsigned n, double p) {
-  std::vector<Edge> edges;
+  std::uint64_t nr_pairs = std::uint64_t(n) * (n - 1) / 2;
+  if (p <= 0.0 || nr_pairs == 0) return {};
+
+  // The pair indices are split into ranges that are generated in
+  // parallel with independent random streams.  The ranges only
+  // depend on n and p (not on the number of threads) and each range
+  // has roughly 2^16 edges in expectation.
+  auto range_size = std::uint64_t(
+      std::max(double(1 << 20), std::min(double(nr_pairs), (1 << 16) / p)));
+  std::uint64_t nr_ranges = (nr_pairs + range_size - 1) / range_size;
+  std::uint64_t seed = Random::natural_number();
+  double log_q = std::log1p(-p);
+
+  std::vector<std::vector<Edge>> edges_by_range(nr_ranges);
+#pragma omp parallel for schedule(dynamic)
+  for (std::uint64_t r = 0; r < nr_ranges; ++r) {
+    RandomStream rng(substream_seed(seed, r));
+    std::uint64_t end = std::min(nr_pairs, (r + 1) * range_size);
 
-  auto next_pair = [](Node u, Node v, unsigned skip) {
-    while (skip + v >= u) {
-      skip -= u - v;
-      u++;
-      v = 0;
+    // number of pairs skipped before the next edge (geometric
+    // distribution)
+    auto skip = [&]() {
+      if (p >= 1.0) return 0.0;
+      return std::floor(std::log1p(-rng.uniform()) / log_q);
+    };
+
+    for (std::uint64_t k = r * range_size;; ++k) {
+      double nr_skipped = skip();
+      if (nr_skipped >= double(end - k)) break;
+      k += std::uint64_t(nr_skipped);
+      edges_by_range[r].push_back(pair_of_index(k));
     }
-    v += skip;
-    return Edge{u, v};
-  };
+  }
 
-  auto edge = next_pair(1, 0, Random::geometric_skip(p));
-  auto [u, v] = edge;
-  while (u < n) {
-    edges.push_back(edge);
-    edge = next_pair(u, v, 1 + Random::geometric_skip(p));
-    u = edge.s;
-    v = edge.t;
+  std::vector<std::size_t> offset(nr_ranges + 1, 0);
+  for (std::uint64_t r = 0; r < nr_ranges; ++r) {
+    offset[r + 1] = offset[r] + edges_by_range[r].size();
+  }
+  std::vector<Edge> edges(offset[nr_ranges]);
+#pragma omp parallel for schedule(dynamic)
+  for (std::uint64_t r = 0; r < nr_ranges; ++r) {
+    std::copy(edges_by_range[r].begin(), edges_by_range[r].end(),
+              edges.begin() + offset[r]);
+    edges_by_range[r] = {};
   }
   return edges;
 }
 
 std::vector<Edge> erdos_renyi(unsigned n, unsigned m) {
-  std::vector<Edge> edges;
-  std::unordered_set<std::string> edges_seen;
-  auto edge_name = [](Node u, Node v) {
-    return std::to_string(std::min(u, v)) + "-" +
-           std::to_string(std::max(u, v));
-  };
-  for (unsigned i = 0; i < m; ++i) {
-    Node u, v;
-    do {  // rejection sampling
-      u = Random::natural_number(n - 1);
-      v = Random::natural_number(n - 1);
-    } while (u == v || edges_seen.count(edge_name(u, v)));
-    edges.push_back(Edge{u, v});
-    edges_seen.insert(edge_name(u, v));
+  std::uint64_t nr_pairs = std::uint64_t(n) * (n - 1) / 2;
+  assert(m <= nr_pairs);
+
+  std::vector<std::uint64_t> pairs(m);
+  std::uint64_t seed = Random::natural_number();
+#pragma omp parallel
+#pragma omp single
+  sample_sorted(0, nr_pairs, m, seed, pairs.data());
+
+  std::vector<Edge> edges(m);
+#pragma omp parallel for
+  for (std::uint64_t i = 0; i < m; ++i) {
+    edges[i] = pair_of_index(pairs[i]);
   }
   return edges;
 }
 
-std::vector<Edge> chung_lu(unsigned n, double ple, double avg_deg, double sigma) {
-  // decreasingly sorted power-law weights
-  auto weights = power_law_weights(n, ple);
-  std::sort(weights.begin(), weights.end(), std::greater<double>());
-
-  // sum of all weights
-  double weight_sum = std::accumulate(weights.begin(), weights.end(), 0.0);
-
+ChungLuWeights::ChungLuWeights(unsigned n, double ple, double avg_deg,
+                               double sigma, double tolerance)
+    : weights(power_law_weights(n, ple)),
+      powers(weights, ple, sigma),
+      weight_sum(sum(weights)) {
   // constant factor increasing the connection probability for
-  // adjusting the average degree; initial value is a rough
-  // estimation: for σ=1 it yields the correct average degree in the
-  // mulit-graph model (i.e., when allowing "probabilities" greater 1)
-  double deg_correction = n * avg_deg / weight_sum;
-  
-  // compute expected number of edges for the weights and the given
-  // degree correction factor
-  auto expected_nr_edges = [&]() {
-    double sum_of_smaller_non_min = 0.0;
-    unsigned num_nodes_with_min = 0;
-    double exp_nr_edges = 0.0;
-    for (Node u = n - 1; u + 1 > 0; --u) {
-      // normalized weight of u: w_u^min(1, τ - σ) / W
-      double w_u_normal = deg_correction *
-                          std::pow(weights[u], std::min(1.0, ple - sigma)) /
-                          weight_sum;
-
-      // sum of all smaller weights to the power of σ
-      double w_v_sigma = std::pow(weights[u], sigma);
-      if (w_u_normal * w_v_sigma <= 1.0) {
-        // not yet in the regime where probabilities are > 1
-        sum_of_smaller_non_min += w_v_sigma;
-      } else {
-        // in the regime where probabilities are > 1 -> correct the sum
-        num_nodes_with_min++;
-        for (Node v = u + num_nodes_with_min; v < n; ++v) {
-          double w_v_sigma = std::pow(weights[v], sigma);
-          if (w_u_normal * w_v_sigma <= 1.0) {
-            break;
-          }
-          num_nodes_with_min++;
-          sum_of_smaller_non_min -= w_v_sigma;
-        }
-      }
+  // adjusting the average degree: the expected number of edges is
+  // computed on weight classes and matched with n avg_deg / 2 up to a
+  // relative error of tolerance; the classes are fine enough for the
+  // estimation error to be far below the tolerance; initial guess: for
+  // σ=1 it yields the correct average degree in the mulit-graph model
+  // (i.e., when allowing "probabilities" greater 1)
+  ChungLuEdgeEstimator expected_nr_edges(weights, powers, 1 + tolerance);
+  deg_correction = find_root(expected_nr_edges, 0.5 * avg_deg * n,
+                             n * avg_deg / weight_sum, tolerance);
+}
 
-      // add part to the sum where the minimum applies
-      double sum_of_smaller =
-          sum_of_smaller_non_min + num_nodes_with_min / w_u_normal;
+std::vector<Edge> chung_lu(const ChungLuWeights& w) {
+  unsigned n = w.weights.size();
 
-      // update expected number of edges
-      exp_nr_edges += w_u_normal * sum_of_smaller;
-    }
-    return exp_nr_edges;
-  };
-  
-  // adjust the degree correction factor to yield a better estimate
-  // for the expected average degree; this can be repeated to yield
-  // slightly better results (more than twice seems unnecessary)
-  deg_correction *= 0.5 * avg_deg * n / expected_nr_edges();
-  deg_correction *= 0.5 * avg_deg * n / expected_nr_edges();
-  
   // connection probability
   auto p = [&](Node u, Node v) {
     // we only call this for u < v and thus weights(u) > weights(v)
-    assert(weights[v] <= weights[u]);
-    double w_min = std::pow(weights[v], sigma);
-    double w_max = std::pow(weights[u], std::min(1.0, ple - sigma));
-    return std::min(deg_correction * w_min * w_max / weight_sum, 1.0);
+    assert(w.weights[v] <= w.weights[u]);
+    return std::min(w.deg_correction * w.powers.light[v] * w.powers.heavy[u] /
+                        w.weight_sum,
+                    1.0);
   };
 
   // generate
@@ -132,6 +168,9 @@ std::vector<Edge> chung_lu(unsigned n, double ple, double avg_deg, double sigma)
     while (true) {
       // skip some vertices using an upper bound on the connection probability
       v++;
+      if (v >= n) {
+        break;
+      }
       double p_uv_upper = p(u, v);
       v += Random::geometric_skip(p_uv_upper);
       if (v >= n) {
@@ -147,11 +186,262 @@ std::vector<Edge> chung_lu(unsigned n, double ple, double avg_deg, double sigma)
   return edges;
 }
 
-std::vector<double> power_law_weights(unsigned n, double ple) {
-  std::vector<double> weights(n);
-  double exponent = -1 / (ple - 1);
-  for (unsigned i = 0; i < n; ++i) {
-    weights[i] = std::pow(i + 1, exponent);
+std::vector<Edge> chung_lu(unsigned n, double ple, double avg_deg, double sigma,
+                           double tolerance) {
+  return chung_lu(ChungLuWeights(n, ple, avg_deg, sigma, tolerance));
+}
+
+ChungLuOutOfCore::ChungLuOutOfCore(unsigned n, double ple, double avg_deg,
+                                   double sigma, double tolerance)
+    : n(n), ple(ple), sigma(sigma) {
+  // calibration as for ChungLuWeights, but with the powers of the
+  // weights computed on the fly
+  std::vector<double> weights = power_law_weights(n, ple);
+  ChungLuEdgeEstimator expected_nr_edges(weights, ple, sigma, 1 + tolerance);
+  weight_sum = sum(weights);
+  light_sum = expected_nr_edges.light_sum();
+  deg_correction = find_root(expected_nr_edges, 0.5 * avg_deg * n,
+                             n * avg_deg / weight_sum, tolerance);
+}
+
+void chung_lu(const ChungLuOutOfCore& params,
+              const std::function<void(const std::vector<Edge>&)>& emit) {
+  unsigned n = params.n;
+  double exponent_heavy = std::min(1.0, params.ple - params.sigma);
+  double factor = params.deg_correction / params.weight_sum;
+
+  // Blocks of sources: the expected number of edges of source u is at
+  // most min(n - 1 - u, factor w_u^min(1, τ - σ) sum_v w_v^σ), which
+  // is decreasing in u.  Thus, a block starting at u can contain
+  // max_block_edges / bound(u) sources.  The blocks only depend on the
+  // parameters (not on the number of threads).
+  const double max_block_edges = 1 << 20;
+  const unsigned max_block_size = 1 << 16;
+  std::vector<Node> block_begin = {0};
+  while (block_begin.back() < n) {
+    Node u = block_begin.back();
+    double bound = std::min(
+        double(n - 1 - u),
+        factor * power_law_weight(u, params.ple, exponent_heavy) *
+            params.light_sum);
+    auto size = unsigned(std::clamp(max_block_edges / bound, 1.0,
+                                    double(max_block_size)));
+    block_begin.push_back(n - u <= size ? n : u + size);
+  }
+  std::size_t nr_blocks = block_begin.size() - 1;
+
+  // The blocks are generated in batches with a few blocks per thread
+  // (with one random stream per block); each batch is passed to emit
+  // before the next one is generated.
+  std::uint64_t seed = Random::natural_number();
+  std::size_t batch_size = 4 * omp_get_max_threads();
+  std::vector<std::vector<Edge>> edges_by_block(batch_size);
+  std::vector<Edge> batch_edges;
+  for (std::size_t batch = 0; batch < nr_blocks; batch += batch_size) {
+    std::size_t batch_end = std::min(nr_blocks, batch + batch_size);
+#pragma omp parallel for schedule(dynamic)
+    for (std::size_t block = batch; block < batch_end; ++block) {
+      RandomStream rng(substream_seed(seed, block));
+      std::vector<Edge>& edges = edges_by_block[block - batch];
+      edges.clear();
+      for (Node u = block_begin[block]; u < block_begin[block + 1]; ++u) {
+        double x =
+            factor * power_law_weight(u, params.ple, exponent_heavy);
+        auto p = [&](Node v) {
+          return std::min(
+              1.0, x * power_law_weight(v, params.ple, params.sigma));
+        };
+        // same as in chung_lu() with the skips of the random stream
+        for (Node v = u + 1; v < n; ++v) {
+          double p_upper = p(v);
+          if (p_upper <= 0.0) break;
+          if (p_upper < 1.0) {
+            double nr_skipped =
+                std::floor(std::log1p(-rng.uniform()) / std::log1p(-p_upper));
+            if (nr_skipped >= double(n - v)) break;
+            v += Node(nr_skipped);
+            if (!rng.coin_flip(p(v) / p_upper)) continue;
+          }
+          edges.push_back(Edge{u, v});
+        }
+      }
+    }
+
+    batch_edges.clear();
+    for (std::size_t block = batch; block < batch_end; ++block) {
+      auto& edges = edges_by_block[block - batch];
+      batch_edges.insert(batch_edges.end(), edges.begin(), edges.end());
+    }
+    emit(batch_edges);
+  }
+}
+
+namespace {
+
+// Weights of one side (sources or targets) of a Chung-Lu graph with
+// separate weights for both sides, sorted decreasingly.  The i-th
+// heaviest vertex has id id[i].  Besides the weights, the powers used
+// by the connection probability are precomputed.
+struct SideWeights {
+  SideWeights(std::vector<double> weights, std::vector<Node> ids, double ple,
+              double sigma)
+      : weight(std::move(weights)),
+        id(std::move(ids)),
+        powers(weight, ple, sigma) {}
+
+  std::size_t size() const { return weight.size(); }
+
+  std::vector<double> weight;
+  std::vector<Node> id;
+  SigmaWeights powers;
+};
+
+// Weight part of the connection probability of the i-th source and
+// the j-th target, i.e., the probability without the factor adjusting
+// the average degree and without capping it at 1.  For fixed i, it is
+// non-increasing in j among the targets at least as heavy as the
+// source and among the lighter targets (but it can jump up in between
+// if the exponents of both sides differ).
+double weight_part(const SideWeights& sources, std::size_t i,
+                   const SideWeights& targets, std::size_t j) {
+  return sources.weight[i] <= targets.weight[j]
+             ? sources.powers.light[i] * targets.powers.heavy[j]
+             : sources.powers.heavy[i] * targets.powers.light[j];
+}
+
+// Factor for the weight part such that the expected number of
+// connected pairs (source, target) is m.  The expectation is
+// estimated on weight classes.
+double chung_lu_factor(const SideWeights& sources, const SideWeights& targets,
+                       double m) {
+  WeightClasses source_classes(sources.weight);
+  WeightClasses target_classes(targets.weight);
+  auto expected_nr_pairs = [&](double factor) {
+    double sum = 0;
+    for (unsigned c1 = 0; c1 < source_classes.size(); ++c1) {
+      // each class is represented by its middle vertex
+      std::size_t i = (source_classes.begin(c1) + source_classes.end(c1)) / 2;
+      for (unsigned c2 = 0; c2 < target_classes.size(); ++c2) {
+        std::size_t j = (target_classes.begin(c2) + target_classes.end(c2)) / 2;
+        double p = std::min(1.0, factor * weight_part(sources, i, targets, j));
+        sum += double(source_classes.count(c1)) * target_classes.count(c2) * p;
+      }
+    }
+    return sum;
+  };
+
+  // initial guess: all probabilities below 1 and σ = 1
+  return find_root(expected_nr_pairs, m,
+                   m / (sum(sources.weight) * sum(targets.weight)));
+}
+
+// Connects each source with each target independently with
+// probability min(1, factor * weight_part).  For each source, the
+// targets are scanned in order of decreasing weight (separately for
+// the targets heavier and lighter than the source), skipping over
+// them using the probability of the current target as upper bound.
+// If no_loops is set, a source and a target with the same id are
+// never connected.  The sources are processed in parallel chunks with
+// independent random streams; the result only depends on the seed.
+std::vector<Edge> chung_lu_edges(const SideWeights& sources,
+                                 const SideWeights& targets, double factor,
+                                 bool no_loops, std::uint64_t seed) {
+  const std::size_t chunk_size = 1 << 12;
+  std::size_t nr_chunks = (sources.size() + chunk_size - 1) / chunk_size;
+  std::vector<std::vector<Edge>> edges_by_chunk(nr_chunks);
+
+#pragma omp parallel for schedule(dynamic)
+  for (std::size_t chunk = 0; chunk < nr_chunks; ++chunk) {
+    RandomStream rng(substream_seed(seed, chunk));
+    std::size_t chunk_end = std::min(sources.size(), (chunk + 1) * chunk_size);
+    for (std::size_t i = chunk * chunk_size; i < chunk_end; ++i) {
+      auto lighter = std::upper_bound(targets.weight.begin(),
+                                      targets.weight.end(), sources.weight[i],
+                                      std::greater<double>());
+      std::size_t split = lighter - targets.weight.begin();
+      for (auto [begin, end] : {std::pair{std::size_t(0), split},
+                                std::pair{split, targets.size()}}) {
+        for (std::size_t j = begin; j < end; ++j) {
+          double p_upper =
+              std::min(1.0, factor * weight_part(sources, i, targets, j));
+          if (p_upper <= 0.0) break;
+          if (p_upper < 1.0) {
+            double nr_skipped =
+                std::floor(std::log1p(-rng.uniform()) / std::log1p(-p_upper));
+            if (nr_skipped >= double(end - j)) break;
+            j += std::size_t(nr_skipped);
+            // correct for the error made by using only an upper bound
+            double p =
+                std::min(1.0, factor * weight_part(sources, i, targets, j));
+            if (!rng.coin_flip(p / p_upper)) continue;
+          }
+          if (no_loops && sources.id[i] == targets.id[j]) continue;
+          edges_by_chunk[chunk].push_back(Edge{sources.id[i], targets.id[j]});
+        }
+      }
+    }
+  }
+
+  std::vector<Edge> edges;
+  for (auto& chunk_edges : edges_by_chunk) {
+    edges.insert(edges.end(), chunk_edges.begin(), chunk_edges.end());
+    chunk_edges = {};
+  }
+  sort_edges(edges);
+  return edges;
+}
+
+std::vector<Node> identity(unsigned n) {
+  std::vector<Node> ids(n);
+  std::iota(ids.begin(), ids.end(), 0);
+  return ids;
+}
+
+}  // namespace
+
+std::vector<Edge> chung_lu_directed(unsigned n, double ple_out, double ple_in,
+                                    double avg_deg, double correlation,
+                                    double sigma) {
+  // vertex v has the v-th largest out-weight
+  SideWeights sources(power_law_weights(n, ple_out), identity(n), ple_out,
+                      sigma);
+
+  // The vertex with the i-th largest out-weight initially gets the
+  // i-th largest in-weight.  Then each vertex is selected with
+  // probability 1 - correlation and the in-weights of the selected
+  // vertices are shuffled randomly.
+  std::vector<Node> in_rank = identity(n);
+  std::uint64_t seed = Random::natural_number();
+  RandomStream rng(substream_seed(seed, 0));
+  std::vector<Node> selected;
+  for (Node v = 0; v < n; ++v) {
+    if (!rng.coin_flip(correlation)) selected.push_back(v);
+  }
+  std::vector<Node> shuffled = selected;
+  std::shuffle(shuffled.begin(), shuffled.end(), rng);
+  for (std::size_t i = 0; i < selected.size(); ++i) {
+    in_rank[selected[i]] = shuffled[i];
   }
-  return weights;
+  // the target with the i-th largest in-weight
+  std::vector<Node> target_ids(n);
+  for (Node v = 0; v < n; ++v) target_ids[in_rank[v]] = v;
+  SideWeights targets(power_law_weights(n, ple_in), std::move(target_ids),
+                      ple_in, sigma);
+
+  // expected number of edges n avg_deg / 2; the self-loops contained
+  // in the estimation are negligible
+  double factor = chung_lu_factor(sources, targets, 0.5 * avg_deg * n);
+  return chung_lu_edges(sources, targets, factor, true,
+                        substream_seed(seed, 1));
+}
+
+std::vector<Edge> chung_lu_bipartite(unsigned n1, unsigned n2, double ple1,
+                                     double ple2, double avg_deg,
+                                     double sigma) {
+  SideWeights sources(power_law_weights(n1, ple1), identity(n1), ple1, sigma);
+  SideWeights targets(power_law_weights(n2, ple2), identity(n2), ple2, sigma);
+  double factor =
+      chung_lu_factor(sources, targets, 0.5 * avg_deg * (double(n1) + n2));
+  return chung_lu_edges(sources, targets, factor, false,
+                        Random::natural_number());
 }
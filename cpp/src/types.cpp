@@ -1,5 +1,11 @@
 #include "types.hpp"
 
+#include <omp.h>
+
+#include <algorithm>
+
+#include "csv_writer.hpp"
+
 std::ostream& operator<<(std::ostream& os, const Point& p) {
   return os << "(" << p.x << ", " << p.y << ")";
   return os;
@@ -30,7 +36,53 @@ std::string name(DegType type) {
 }
 
 void print_edges(const std::vector<Edge>& edges, std::ostream& out) {
+  CsvWriter csv(out, ' ');
   for (const auto& e : edges) {
-    out << e.s << " " << e.t << "\n";
+    csv.line(e.s, e.t);
+  }
+}
+
+void print_edges_konect(const std::vector<Edge>& edges, GraphType type,
+                        std::ostream& out) {
+  switch (type) {
+    case UNDIRECTED:
+      out << "% sym unweighted\n";
+      break;
+    case DIRECTED:
+      out << "% asym unweighted\n";
+      break;
+    case BIPARTITE:
+      out << "% bip unweighted\n";
+      break;
+  }
+  CsvWriter csv(out, ' ');
+  for (const auto& e : edges) {
+    csv.line(e.s + 1, e.t + 1);
+  }
+}
+
+void sort_edges(std::vector<Edge>& edges) {
+  auto less = [](const Edge& e1, const Edge& e2) {
+    return e1.s == e2.s ? e1.t < e2.t : e1.s < e2.s;
+  };
+
+  // sort one block per thread and merge them pairwise
+  std::size_t nr_blocks = omp_get_max_threads();
+  std::size_t block_size = (edges.size() + nr_blocks - 1) / nr_blocks;
+  auto block_begin = [&](std::size_t block) {
+    return edges.begin() + std::min(edges.size(), block * block_size);
+  };
+
+#pragma omp parallel for
+  for (std::size_t block = 0; block < nr_blocks; ++block) {
+    std::sort(block_begin(block), block_begin(block + 1), less);
+  }
+
+  for (std::size_t merged = 1; merged < nr_blocks; merged *= 2) {
+#pragma omp parallel for
+    for (std::size_t block = 0; block < nr_blocks; block += 2 * merged) {
+      std::inplace_merge(block_begin(block), block_begin(block + merged),
+                         block_begin(block + 2 * merged), less);
+    }
   }
 }
@@ -0,0 +1,82 @@
+#include "weights.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace {
+
+// values are summed in blocks of this size
+constexpr std::size_t block_size = 1 << 14;
+
+std::size_t nr_blocks(std::size_t n) {
+  return (n + block_size - 1) / block_size;
+}
+
+// sum of each block
+std::vector<double> block_sums(const std::vector<double>& values) {
+  std::vector<double> sums(nr_blocks(values.size()), 0.0);
+#pragma omp parallel for
+  for (std::size_t b = 0; b < sums.size(); ++b) {
+    std::size_t end = std::min(values.size(), (b + 1) * block_size);
+    double block_sum = 0.0;
+    for (std::size_t i = b * block_size; i < end; ++i) {
+      block_sum += values[i];
+    }
+    sums[b] = block_sum;
+  }
+  return sums;
+}
+
+}  // namespace
+
+std::vector<double> power_law_weights(unsigned n, double ple) {
+  std::vector<double> weights(n);
+#pragma omp parallel for
+  for (unsigned i = 0; i < n; ++i) {
+    weights[i] = power_law_weight(i, ple);
+  }
+  return weights;
+}
+
+SigmaWeights::SigmaWeights(const std::vector<double>& weights, double ple,
+                           double sigma)
+    : light(weights.size()), heavy(weights.size()) {
+  double exponent_heavy = std::min(1.0, ple - sigma);
+#pragma omp parallel for
+  for (std::size_t i = 0; i < weights.size(); ++i) {
+    light[i] = sigma == 1.0 ? weights[i] : std::pow(weights[i], sigma);
+    heavy[i] = exponent_heavy == 1.0 ? weights[i]
+                                     : std::pow(weights[i], exponent_heavy);
+  }
+}
+
+double sum(const std::vector<double>& values) {
+  double result = 0.0;
+  for (double block_sum : block_sums(values)) result += block_sum;
+  return result;
+}
+
+std::vector<double> prefix_sums(const std::vector<double>& values) {
+  // sum up the blocks, then the prefix sums of the blocks, then the
+  // prefix sums within each block
+  std::vector<double> offsets = block_sums(values);
+  double running = 0.0;
+  for (double& offset : offsets) {
+    double block_sum = offset;
+    offset = running;
+    running += block_sum;
+  }
+
+  std::vector<double> result(values.size() + 1);
+  result[0] = 0.0;
+#pragma omp parallel for
+  for (std::size_t b = 0; b < offsets.size(); ++b) {
+    std::size_t end = std::min(values.size(), (b + 1) * block_size);
+    double block_prefix = 0.0;
+    for (std::size_t i = b * block_size; i < end; ++i) {
+      block_prefix += values[i];
+      result[i + 1] = offsets[b] + block_prefix;
+    }
+  }
+  return result;
+}
@@ -61,6 +61,21 @@ run.add(
 )
 
 
+run.add(
+    "hrg",
+    "cpp/release/hrg -n [[n]] --deg [[deg]] --ple [[ple]] -T [[T]] --seed [[seed]] [[file]]",
+    {
+        "n": common_params["n"] + [10000000],
+        "deg": 15,
+        "ple": common_params["ple"],
+        "T": 0,
+        "seed": common_params["seed"],
+        "name": "hrg_n=[[n]]_deg=[[deg]]_ple=[[ple]]_T=[[T]]_seed=[[seed]]",
+        "file": "input_data/graphs/[[name]]",
+    },
+    stdout_file="output_data/hrg_attributes/[[name]].csv",
+)
+
 run.add(
     "girg-warm",
     "cpp/release/girg -n [[n]] --deg [[deg]] --dim [[dim]] --ple [[ple]] -T [[T]] --sigma [[sigma]] --seed [[seed]] [[file]]",
@@ -104,7 +119,7 @@ output_names = [
 ]
 
 # remove all graphs/results with certain prefix
-prefixes = ["girg", "cl"]
+prefixes = ["girg", "cl", "hrg"]
 run.add(
     "rm_[[prefix]]",
     "rm -f input_data/graphs/[[prefix]]_n*",
@@ -131,40 +146,20 @@ graph_names = [os.path.basename(f) for f in glob.glob("input_data/graphs/*")]
 ######################################################################
 run.group("stats")
 
-run.add(
-    "basic_stats",
-    "cpp/release/stats input_data/graphs/[[graph]] --no-header",
-    {"graph": graph_names},
-    stdout_file="output_data/stats/[[graph]].csv",
-    header_command="cpp/release/stats --only-header",
-)
-
-run.add(
-    "degree_distr",
-    "cpp/release/degree_distribution [[edge]] [[bucket_arg]] input_data/graphs/[[graph]] --no-header",
-    {
-        "graph": graph_names,
-        "edge": ["--edge_endpoints", ""],
-        "nr_buckets": 21,
-        "bucket": ["", 0, 5, 10, 15, 20],
-        "bucket_arg": lambda args: (
-            "--nr_buckets [[nr_buckets]] --bucket [[bucket]]"
-            if args["edge"] != "" and args["bucket"] != ""
-            else ""
-        ),
-    },
-    # do not use buckets without edge
-    combinations_filter=lambda args: (args["edge"] != "" or args["bucket"] == ""),
-    stdout_file="output_data/degree_distr/[[graph]].csv",
-    header_command="cpp/release/degree_distribution --only-header",
-)
+# parse each graph only once for all evaluations; the joint histogram
+# is written last (and thus marks completed graphs)
+for output in ["stats", "degree_distr", "joint_histogram"]:
+    os.makedirs(f"output_data/{output}", exist_ok=True)
 
 run.add(
-    "joint_histogram",
-    "cpp/release/joint_histogram input_data/graphs/[[graph]] --nr_buckets=21 --no-header",
-    {"graph": graph_names},
-    stdout_file="output_data/joint_histogram/[[graph]].csv",
-    header_command="cpp/release/joint_histogram --only-header",
+    "analyze",
+    "cpp/release/analyze input_data/graphs/[[graph]] "
+    "--stats output_data/stats/[[graph]].csv "
+    "--degree_distr output_data/degree_distr/[[graph]].csv "
+    "--joint_histogram output_data/joint_histogram/[[graph]].csv "
+    "--nr_buckets [[nr_buckets]] --buckets [[buckets]]",
+    {"graph": graph_names, "nr_buckets": 21, "buckets": "0,5,10,15,20"},
+    creates_file="output_data/joint_histogram/[[graph]].csv",
 )
 
 run.run()
@@ -183,14 +178,14 @@ run.group("post")
 
 run.add(
     "merge_csv",
-    "output_data/merge-csv.sh output_data/[[output]]",
+    "cpp/release/merge_results output_data/[[output]]",
     {"output": output_names},
     creates_file="output_data/[[output]].csv",
 )
 
 run.add(
     "merge_csv_force",
-    "output_data/merge-csv.sh output_data/[[output]]",
+    "cpp/release/merge_results output_data/[[output]]",
     {"output": output_names},
 )
 
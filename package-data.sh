@@ -7,7 +7,7 @@ if [ ! -f "data-packs/$FILE" ]; then
     echo "crating $FILE"
     zip -q -r "data-packs/$FILE" \
         "output_data/" \
-        -x "output_data/.gitignore" "output_data/merge-csv.sh"
+        -x "output_data/.gitignore"
 else
     echo "skipping $FILE (already exists)"
 fi